@@ -16,6 +16,17 @@
 #ifndef _DMBILINEAR_H_
 #define _DMBILINEAR_H_
 
+/** @brief CFA phase index for the red pixel at (RedX, RedY) */
+#define CFA_PHASE(RedX, RedY)   ((RedX) + 2*(RedY))
+/** @brief CFA phase with red at (0,0), the upper-left 2x2 block is RGGB */
+#define CFA_RGGB    0
+/** @brief CFA phase with red at (1,0), the upper-left 2x2 block is GRBG */
+#define CFA_GRBG    1
+/** @brief CFA phase with red at (0,1), the upper-left 2x2 block is GBRG */
+#define CFA_GBRG    2
+/** @brief CFA phase with red at (1,1), the upper-left 2x2 block is BGGR */
+#define CFA_BGGR    3
+
 void CfaFlatten(float *Cfa, const float *Input, int Width, int Height, 
     int RedX, int RedY);
 
@@ -20,86 +20,330 @@
 #include "conv.h"
 
 
-static void SepConv2(float *Dest, float *Temp, 
-    int DestPixelStride, int DestRowStride,
-    const float *Src, int SrcPixelStride, int SrcRowStride, 
-    int Width, int Height, const filter Horiz, const filter Vert)
+/** @brief Number of rows buffered after the analysis filtering */
+#define ANALYSIS_RING       3
+/** @brief Number of rows buffered after the horizontal synthesis */
+#define SYNTHESIS_RING      5
+/** @brief Input rows needed beyond each side of a band of output rows */
+#define HALO_ROWS           3
+/** @brief Workspace size in rows needed by DetailProjectionBand */
+#define DETAIL_WORKSPACE_ROWS   (3*ANALYSIS_RING + 4*SYNTHESIS_RING + 2 \
+    + 2*HALO_ROWS)
+/** @brief Minimum number of rows in a band for threaded execution */
+#define MIN_BAND_ROWS       16
+
+
+/** @brief Description of one detail projection */
+typedef struct
 {
-    boundaryext Boundary = GetBoundaryExt("symw");
-    int i;
+    /** @brief The channel to project, overwritten in place */
+    float *Dest;
+    /** @brief The channel providing the details */
+    const float *SrcHigh;
+    /** @brief Strides of Dest, SrcHigh, and Mosaiced */
+    int PixelStride, RowStride;
+    /** @brief The signal dimensions */
+    int Width, Height;
+    /** @brief If non-NULL, the observed data to copy onto (ObsX, ObsY) */
+    const float *Mosaiced;
+    /** @brief Offset of the observed sublattice */
+    int ObsX, ObsY;
+} projection;
+
+
+/** @brief Whole-sample symmetric boundary extension of an index */
+static int SymwIndex(int n, int N)
+{
+    while(1)
+    {
+        if(n < 0)
+            n = -n;
+        else if(n >= N)
+            n = 2*(N - 1) - n;
+        else
+            return n;
+    }
+}
+
+
+/**
+ * @brief Vertical filtering of one row from a ring buffer of rows
+ * @param Dest output row
+ * @param Ring ring buffer, row m is stored at Ring + Width*(m % RingSize)
+ * @param RingSize number of rows in the ring
+ * @param Filter the filter
+ * @param n the output row index
+ * @param Width, Height the signal dimensions
+ *
+ * Computes the same result as Conv1D with "symw" boundary extension down
+ * the columns, including the order in which the taps are summed (Conv1D 
+ * sums in reverse tap order on the interior and forward order near the 
+ * boundaries), but visits the columns with unit stride.
+ */
+static void VerticalConvRow(float *Dest, const float *Ring, int RingSize,
+    filter Filter, int n, int Width, int Height)
+{
+    const int LeftmostTap = 1 - Filter.Delay - Filter.Length;
+    const int StartInterior = (-LeftmostTap < 0) ? 0 : 
+        ((-LeftmostTap > Height - 1) ? Height - 1 : -LeftmostTap);
+    const int EndInterior = (Filter.Delay < 0) ? 
+        (Height + Filter.Delay - 1) : (Height - 1);
+    const int Interior = (StartInterior <= n && n <= EndInterior);
+    const float *Src;
+    float Coeff;
+    int j, k, x;
     
-    for(i = 0; i < Height; i++)
-        Conv1D(Temp + Width*i, 1, Src + SrcRowStride*i, SrcPixelStride,
-            Horiz, Boundary, Width);
     
-    for(i = 0; i < Width; i++)
-        Conv1D(Dest + DestPixelStride*i, DestRowStride, Temp + i, Width,
-            Vert, Boundary, Height);
+    for(x = 0; x < Width; x++)
+        Dest[x] = 0;
+    
+    for(j = 0; j < Filter.Length; j++)
+    {
+        k = (Interior) ? Filter.Length - 1 - j : j;
+        Coeff = Filter.Coeff[k];
+        Src = Ring + Width*(SymwIndex(n - Filter.Delay - k, Height) 
+            % RingSize);
+        
+        for(x = 0; x < Width; x++)
+            Dest[x] += Coeff*Src[x];
+    }
 }
 
 
-static void WaveletTransform(float *CA, float *CH, float *CV, float *CD,
-    float *ConvTemp, const float *SrcLow, const float *SrcHigh, 
-    int SrcPixelStride, int SrcRowStride, int Width, int Height, 
-    const filter h0, const filter h1)
+/**
+ * @brief Save the input rows adjacent to a band
+ * @param Halo array of 2*HALO_ROWS rows
+ * @param P the projection
+ * @param y0, y1 the band is output rows y0 to y1 - 1
+ *
+ * The rows within HALO_ROWS above and below the band are owned by the 
+ * neighboring bands, which overwrite them in place.  They are copied 
+ * before any band starts so that each band sees the unmodified input.
+ */
+static void SaveHalo(float *Halo, const projection *P, int y0, int y1)
 {
-    SepConv2(CA, ConvTemp, 1, Width, 
-        SrcLow, SrcPixelStride, SrcRowStride,
-        Width, Height, h0, h0);
+    const float *Src;
+    int t, x;
+    
+    
+    for(t = y0 - HALO_ROWS; t < y1 + HALO_ROWS; t++)
+        if(0 <= t && t < P->Height && (t < y0 || t >= y1))
+        {
+            Src = P->Dest + P->RowStride*t;
+            
+            for(x = 0; x < P->Width; x++)
+                Halo[P->Width*((t < y0) ? t - y0 + HALO_ROWS 
+                    : t - y1 + HALO_ROWS) + x] = Src[P->PixelStride*x];
+        }
+}
+
+
+/**
+ * @brief Fused wavelet detail projection on a band of rows
+ * @param P the projection
+ * @param y0, y1 the band is output rows y0 to y1 - 1
+ * @param Workspace workspace of DETAIL_WORKSPACE_ROWS*Width floats, the 
+ *    first 2*HALO_ROWS rows filled by SaveHalo
+ * @param h0, h1, g0, g1 the analysis and synthesis filters
+ * @return the squared L^2 change of Dest over the band
+ *
+ * Replaces the channel with the wavelet reconstruction from its own 
+ * approximation subband and the detail subbands of SrcHigh.  This is the
+ * same as four separable analysis convolutions into full-size subbands 
+ * followed by four synthesis convolutions, but the image is streamed by 
+ * rows.  At step t, row t is filtered horizontally by the analysis 
+ * filters, row t - 1 of each subband is filtered vertically and then 
+ * horizontally by the synthesis filters, and output row t - 3 is 
+ * synthesized vertically.  Only ring buffers of a few rows are kept, so 
+ * the working set stays in cache and each pixel of Dest is written once.
+ * The arithmetic is the same as with Conv1D, so the result is identical.
+ *
+ * Every output row is computed the same way regardless of the band 
+ * limits, so splitting the image into bands does not change the result.
+ */
+static double DetailProjectionBand(const projection *P, int y0, int y1,
+    float *Workspace, filter h0, filter h1, filter g0, filter g1)
+{
+    boundaryext Boundary = GetBoundaryExt("symw");
+    const int Width = P->Width, Height = P->Height;
+    float *Halo = Workspace;
+    float *LowH0 = Halo + 2*HALO_ROWS*Width;
+    float *HighH0 = LowH0 + ANALYSIS_RING*Width;
+    float *HighH1 = HighH0 + ANALYSIS_RING*Width;
+    float *SynA = HighH1 + ANALYSIS_RING*Width;
+    float *SynH = SynA + SYNTHESIS_RING*Width;
+    float *SynV = SynH + SYNTHESIS_RING*Width;
+    float *SynD = SynV + SYNTHESIS_RING*Width;
+    float *Temp = SynD + SYNTHESIS_RING*Width;
+    float *Sum = Temp + Width;
+    const float *SrcRow;
+    float *DestRow;
+    double Change = 0;
+    int t, n, x, Offset, SrcStride;
+    
+    
+    for(t = (y0 >= HALO_ROWS) ? y0 - HALO_ROWS : 0; 
+        t < y1 + HALO_ROWS; t++)
+    {
+        if(t < Height)
+        {
+            /* Horizontal analysis filtering of row t */
+            if(t < y0 || t >= y1)
+            {
+                SrcRow = Halo + Width*((t < y0) ? t - y0 + HALO_ROWS 
+                    : t - y1 + HALO_ROWS);
+                SrcStride = 1;
+            }
+            else
+            {
+                SrcRow = P->Dest + P->RowStride*t;
+                SrcStride = P->PixelStride;
+            }
+            
+            Offset = Width*(t % ANALYSIS_RING);
+            Conv1D(LowH0 + Offset, 1, SrcRow, SrcStride, 
+                h0, Boundary, Width);
+            Conv1D(HighH0 + Offset, 1, P->SrcHigh + P->RowStride*t, 
+                P->PixelStride, h0, Boundary, Width);
+            Conv1D(HighH1 + Offset, 1, P->SrcHigh + P->RowStride*t, 
+                P->PixelStride, h1, Boundary, Width);
+        }
+        
+        n = t - 1;
         
-    SepConv2(CH, ConvTemp, 1, Width, 
-        SrcHigh, SrcPixelStride, SrcRowStride,
-        Width, Height, h1, h0);
+        if(y0 - 2 <= n && n < y1 + 2 && 0 <= n && n < Height)
+        {
+            /* Vertical analysis and horizontal synthesis of row n */
+            Offset = Width*(n % SYNTHESIS_RING);
+            VerticalConvRow(Temp, LowH0, ANALYSIS_RING, h0, n, Width, Height);
+            Conv1D(SynA + Offset, 1, Temp, 1, g0, Boundary, Width);
+            VerticalConvRow(Temp, HighH1, ANALYSIS_RING, h0, n, Width, Height);
+            Conv1D(SynH + Offset, 1, Temp, 1, g1, Boundary, Width);
+            VerticalConvRow(Temp, HighH0, ANALYSIS_RING, h1, n, Width, Height);
+            Conv1D(SynV + Offset, 1, Temp, 1, g0, Boundary, Width);
+            VerticalConvRow(Temp, HighH1, ANALYSIS_RING, h1, n, Width, Height);
+            Conv1D(SynD + Offset, 1, Temp, 1, g1, Boundary, Width);
+        }
         
-    SepConv2(CV, ConvTemp, 1, Width, 
-        SrcHigh, SrcPixelStride, SrcRowStride,
-        Width, Height, h0, h1);
+        n = t - 3;
         
-    SepConv2(CD, ConvTemp, 1, Width, 
-        SrcHigh, SrcPixelStride, SrcRowStride,
-        Width, Height, h1, h1);
+        if(y0 <= n && n < y1)
+        {
+            /* Vertical synthesis of row n, summing the four subbands */
+            VerticalConvRow(Sum, SynA, SYNTHESIS_RING, g0, n, Width, Height);
+            VerticalConvRow(Temp, SynH, SYNTHESIS_RING, g0, n, Width, Height);
+            
+            for(x = 0; x < Width; x++)
+                Sum[x] += Temp[x];
+            
+            VerticalConvRow(Temp, SynV, SYNTHESIS_RING, g1, n, Width, Height);
+            
+            for(x = 0; x < Width; x++)
+                Sum[x] += Temp[x];
+            
+            VerticalConvRow(Temp, SynD, SYNTHESIS_RING, g1, n, Width, Height);
+            
+            for(x = 0; x < Width; x++)
+                Sum[x] += Temp[x];
+            
+            /* Observation projection */
+            if(P->Mosaiced && (n & 1) == P->ObsY)
+                for(x = P->ObsX; x < Width; x += 2)
+                    Sum[x] = P->Mosaiced[P->RowStride*n + P->PixelStride*x];
+            
+            DestRow = P->Dest + P->RowStride*n;
+            
+            for(x = 0; x < Width; x++)
+            {
+                Change += (Sum[x] - DestRow[P->PixelStride*x])
+                    *(Sum[x] - DestRow[P->PixelStride*x]);
+                DestRow[P->PixelStride*x] = Sum[x];
+            }
+        }
+    }
+    
+    return Change;
 }
 
 
-static void InverseWaveletTransform(float *Synthesis,
-    float *SumTemp, float *ConvTemp, int DestPixelStride, int DestRowStride,
-    const float *CA, const float *CH, const float *CV, const float *CD,
-    int Width, int Height, const filter g0, const filter g1)
+/**
+ * @brief Perform independent detail projections, possibly in parallel
+ * @param Proj array of projections, which must not write each other's input
+ * @param NumProj number of projections
+ * @param NumBands number of bands to split each projection into
+ * @param Workspace workspace of NumProj*NumBands*DETAIL_WORKSPACE_ROWS*Width
+ *    floats, where Width is the largest projection width
+ * @param Width the largest projection width
+ * @param NumThreads number of threads to use
+ * @param h0, h1, g0, g1 the analysis and synthesis filters
+ * @param TaskChange array of NumProj*NumBands doubles for the changes
+ * @return the L^2 change of the projected channels
+ *
+ * Each (projection, band) pair is a task with its own workspace.  All 
+ * halos are saved first, then the tasks run.  Since the result does not 
+ * depend on the banding or the order of execution, the output is the 
+ * same for any number of threads.  Without OpenMP the tasks simply run 
+ * one after another.
+ */
+static double DetailProjections(const projection *Proj, int NumProj, 
+    int NumBands, float *Workspace, int Width, int NumThreads,
+    filter h0, filter h1, filter g0, filter g1, double *TaskChange)
 {
-    int x, y;
+    const long TaskWorkspace = ((long)DETAIL_WORKSPACE_ROWS)*Width;
+    const int NumTasks = NumProj*NumBands;
+    double Change;
+    int Task;
     
     
-    SepConv2(SumTemp, ConvTemp, 1, Width, 
-        CA, 1, Width, Width, Height, g0, g0);
-        
-    for(y = 0; y < Height; y++)
-        for(x = 0; x < Width; x++)
-            Synthesis[DestPixelStride*x + DestRowStride*y] 
-                = SumTemp[x + Width*y];
+#pragma omp parallel for num_threads(NumThreads) schedule(static)
+    for(Task = 0; Task < NumTasks; Task++)
+    {
+        const projection *P = Proj + Task/NumBands;
+        const int Band = Task % NumBands;
         
-    SepConv2(SumTemp, ConvTemp, 1, Width, 
-        CH, 1, Width, Width, Height, g1, g0);
-    
-    for(y = 0; y < Height; y++)
-        for(x = 0; x < Width; x++)
-            Synthesis[DestPixelStride*x + DestRowStride*y] 
-                += SumTemp[x + Width*y];
+        SaveHalo(Workspace + TaskWorkspace*Task, P, 
+            (P->Height*Band)/NumBands, (P->Height*(Band + 1))/NumBands);
+    }
     
-    SepConv2(SumTemp, ConvTemp, 1, Width, 
-        CV, 1, Width, Width, Height, g0, g1);
+#pragma omp parallel for num_threads(NumThreads) schedule(static)
+    for(Task = 0; Task < NumTasks; Task++)
+    {
+        const projection *P = Proj + Task/NumBands;
+        const int Band = Task % NumBands;
+        
+        TaskChange[Task] = DetailProjectionBand(P, 
+            (P->Height*Band)/NumBands, (P->Height*(Band + 1))/NumBands, 
+            Workspace + TaskWorkspace*Task, h0, h1, g0, g1);
+    }
     
-    for(y = 0; y < Height; y++)
-        for(x = 0; x < Width; x++)
-            Synthesis[DestPixelStride*x + DestRowStride*y] 
-                += SumTemp[x + Width*y];
+    /* Sum in a fixed order so that the result does not depend on the
+       number of threads */
+    for(Task = 0, Change = 0; Task < NumTasks; Task++)
+        Change += TaskChange[Task];
     
-    SepConv2(SumTemp, ConvTemp, 1, Width, 
-        CD, 1, Width, Width, Height, g1, g1);
+    return sqrt(Change);
+}
+
+
+/**
+ * @brief Set up a projection
+ */
+static projection MakeProjection(float *Dest, const float *SrcHigh,
+    int PixelStride, int RowStride, int Width, int Height, 
+    const float *Mosaiced, int ObsX, int ObsY)
+{
+    projection P;
     
-    for(y = 0; y < Height; y++)
-        for(x = 0; x < Width; x++)
-            Synthesis[DestPixelStride*x + DestRowStride*y] 
-                += SumTemp[x + Width*y];
+    P.Dest = Dest;
+    P.SrcHigh = SrcHigh;
+    P.PixelStride = PixelStride;
+    P.RowStride = RowStride;
+    P.Width = Width;
+    P.Height = Height;
+    P.Mosaiced = Mosaiced;
+    P.ObsX = ObsX;
+    P.ObsY = ObsY;
+    return P;
 }
 
 
@@ -109,14 +353,29 @@ static void InverseWaveletTransform(float *Synthesis,
  * @param Image an initial demosaicing of the image
  * @param Width, Height the image dimensions
  * @param RedX, RedY the coordinates of the upper-rightmost red pixel
- * @param NumIter number of iterations to perform
+ * @param NumIter maximum number of iterations to perform
+ * @param Tol stopping tolerance relative to the norm of the mosaiced 
+ *    data, or zero to always perform NumIter iterations
+ * @param ShowIterations if nonzero, display the L^2 change and the time 
+ *    of each iteration
+ * @param NumThreads number of threads to use (effective if compiled with
+ *    OpenMP support)
  *
  * Image is a float array of the input RGB values of size 
  * 3*Width*Height in planar row-major order.  RedX, RedY are the coordinates
  * of the upper-rightmost red pixel to specify the CFA pattern.
+ *
+ * If Tol is positive, the iterations stop early once the L^2 change of
+ * the red and blue channels in an iteration is at most Tol times the 
+ * L^2 norm of the mosaiced data.
+ *
+ * The red and blue projections within each step are independent and run
+ * concurrently, each split into bands of rows.  The result is identical 
+ * for any number of threads.
  */
 int GunturkDemosaic(float *Image, int Width, int Height, 
-    int RedX, int RedY, int NumIter)
+    int RedX, int RedY, int NumIter, float Tol, int ShowIterations,
+    int NumThreads)
 {
     /* The wavelet filters */
     static float h0Coeff[3] = {0.25f, 0.5f, 0.25f};    
@@ -124,7 +383,6 @@ int GunturkDemosaic(float *Image, int Width, int Height,
     static float g0Coeff[5] = {-0.125f, 0.25f, 0.75f, 0.25f, -0.125f};
     static float g1Coeff[5] = {0.125f, 0.25f, -0.75f, 0.25f, 0.125f};
     filter h0, h1, g0, g1;
-    const int Green = 1 - ((RedX + RedY) & 1);
     const int NumPixels = Width*Height;
     const int RedWidth = (Width + 1 - RedX)/2;
     const int RedHeight = (Height + 1 - RedY)/2;
@@ -135,9 +393,12 @@ int GunturkDemosaic(float *Image, int Width, int Height,
     float *OutputRed = Image;
     float *OutputGreen = Image + Width*Height;
     float *OutputBlue = Image + 2*Width*Height;
-    float *Mosaiced = NULL, *CA = NULL, *CH = NULL, *CV = NULL, *CD = NULL;
-    float *SumTemp = NULL, *ConvTemp = NULL;    
-    int i, x, y, Iter, Success = 0;
+    float *Mosaiced = NULL, *Workspace = NULL;
+    double *TaskChange = NULL;
+    double Change = 0, InputNorm;
+    unsigned long StartTime;
+    projection Proj[2];
+    int Iter, NumBands, i, Success = 0;
     
     
     h0 = MakeFilter(h0Coeff, -1, 3);
@@ -145,78 +406,69 @@ int GunturkDemosaic(float *Image, int Width, int Height,
     g0 = MakeFilter(g0Coeff, -2, 5);
     g1 = MakeFilter(g1Coeff, -2, 5);
     
+    /* Split each projection into bands of at least MIN_BAND_ROWS rows on
+       the half-resolution sublattices */
+    NumBands = (NumThreads < 1) ? 1 : NumThreads;
+    
+    if(NumBands > (Height/2)/MIN_BAND_ROWS)
+        NumBands = ((Height/2)/MIN_BAND_ROWS > 1) ? 
+            (Height/2)/MIN_BAND_ROWS : 1;
+    
     if(!(Mosaiced = (float *)Malloc(sizeof(float)*NumPixels))
-        || !(CA = (float *)Malloc(sizeof(float)*NumPixels))
-        || !(CH = (float *)Malloc(sizeof(float)*NumPixels))
-        || !(CV = (float *)Malloc(sizeof(float)*NumPixels))
-        || !(CD = (float *)Malloc(sizeof(float)*NumPixels))
-        || !(SumTemp = (float *)Malloc(sizeof(float)*NumPixels))
-        || !(ConvTemp = (float *)Malloc(sizeof(float)*NumPixels)))
+        || !(Workspace = (float *)Malloc(sizeof(float)*2*NumBands
+            *DETAIL_WORKSPACE_ROWS*Width))
+        || !(TaskChange = (double *)Malloc(sizeof(double)*2*NumBands)))
         goto Catch;
     
     /* Save a copy of the input mosaiced data as a flattened 2D array */
     CfaFlatten(Mosaiced, Image, Width, Height, RedX, RedY);
     
-    /* Copy the wavelet details from the red and blue sublattices */
-    WaveletTransform(CA, CH, CV, CD, ConvTemp, 
-        OutputGreen + RedX + Width*RedY,
-        OutputRed + RedX + Width*RedY,
-        2, 2*Width, RedWidth, RedHeight, h0, h1);
+    /* Scale Tol by the norm of the mosaiced data */
+    for(i = 0, InputNorm = 0; i < NumPixels; i++)
+        InputNorm += Mosaiced[i]*Mosaiced[i];
     
-    InverseWaveletTransform(OutputGreen + RedX + Width*RedY, 
-        SumTemp, ConvTemp, 2, 2*Width,
-        CA, CH, CV, CD, RedWidth, RedHeight, g0, g1);
+    Tol *= (float)sqrt(InputNorm);
+    
+    /* Copy the wavelet details from the red and blue sublattices */
+    Proj[0] = MakeProjection(OutputGreen + RedX + Width*RedY, 
+        OutputRed + RedX + Width*RedY, 2, 2*Width, RedWidth, RedHeight, 
+        NULL, 0, 0);
+    Proj[1] = MakeProjection(OutputGreen + BlueX + Width*BlueY, 
+        OutputBlue + BlueX + Width*BlueY, 2, 2*Width, BlueWidth, BlueHeight,
+        NULL, 0, 0);
+    DetailProjections(Proj, 2, NumBands, Workspace, Width, NumThreads,
+        h0, h1, g0, g1, TaskChange);
     
-    WaveletTransform(CA, CH, CV, CD, ConvTemp,
-        OutputGreen + BlueX + Width*BlueY,
-        OutputBlue + BlueX + Width*BlueY,
-        2, 2*Width, BlueWidth, BlueHeight, h0, h1);
+    /* Detail projection, copy green channel details, followed by 
+       observation projection */
+    Proj[0] = MakeProjection(OutputRed, OutputGreen, 1, Width, 
+        Width, Height, Mosaiced, RedX, RedY);
+    Proj[1] = MakeProjection(OutputBlue, OutputGreen, 1, Width, 
+        Width, Height, Mosaiced, BlueX, BlueY);
     
-    InverseWaveletTransform(OutputGreen + BlueX + Width*BlueY, 
-        SumTemp, ConvTemp, 2, 2*Width,
-        CA, CH, CV, CD, BlueWidth, BlueHeight, g0, g1);
+    if(ShowIterations)
+        printf(" Iter     Change  Time (ms)\n");
     
-    for(Iter = 0; Iter < NumIter; Iter++)
+    for(Iter = 1; Iter <= NumIter; Iter++)
     {
-        /* Detail projection, copy green channel details */
-        WaveletTransform(CA, CH, CV, CD, ConvTemp,
-            OutputRed, OutputGreen,
-            1, Width, Width, Height, h0, h1);
+        StartTime = Clock();
+        Change = DetailProjections(Proj, 2, NumBands, Workspace, Width, 
+            NumThreads, h0, h1, g0, g1, TaskChange);
         
-        InverseWaveletTransform(OutputRed, 
-            SumTemp, ConvTemp, 1, Width,
-            CA, CH, CV, CD, Width, Height, g0, g1);
+        if(ShowIterations)
+            printf("%5d %10.4f %10lu\n", Iter, Change, Clock() - StartTime);
         
-        WaveletTransform(CA, CH, CV, CD, ConvTemp,
-            OutputBlue, OutputGreen,
-            1, Width, Width, Height, h0, h1);
-        
-        InverseWaveletTransform(OutputBlue, 
-            SumTemp, ConvTemp, 1, Width,
-            CA, CH, CV, CD, Width, Height, g0, g1);
-        
-        /* Observation projection */
-        for(y = 0, i = 0; y < Height; y++)
-            for(x = 0; x < Width; x++, i++)
-            {
-                if(((x + y) & 1) != Green)
-                {
-                    if((y & 1) == RedY)
-                        OutputRed[i] = Mosaiced[i];
-                    else
-                        OutputBlue[i] = Mosaiced[i];
-                }
-            }
+        if(Tol > 0 && Change <= Tol)
+        {
+            printf("Converged in %d iterations.\n", Iter);
+            break;
+        }
     }
     
     Success = 1;
 Catch:  
-    Free(ConvTemp);
-    Free(SumTemp);
-    Free(CD);
-    Free(CV);
-    Free(CH);
-    Free(CA);
+    Free(TaskChange);
+    Free(Workspace);
     Free(Mosaiced);
     return Success;
 }
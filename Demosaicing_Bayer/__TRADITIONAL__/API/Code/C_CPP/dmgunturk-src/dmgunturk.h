@@ -17,6 +17,7 @@
 #define _DMGUNTURK_H_
 
 int GunturkDemosaic(float *Image, int Width, int Height, 
-    int RedX, int RedY, int NumIter);
+    int RedX, int RedY, int NumIter, float Tol, int ShowIterations,
+    int NumThreads);
 
 #endif /* _DMGUNTURK_H_ */
@@ -44,8 +44,14 @@ typedef struct
     int RedX;
     /** @brief CFA pattern upperleftmost red pixel y-coordinate */
     int RedY;
-    /** @brief Number of POCS iterations to perform */
+    /** @brief Maximum number of POCS iterations to perform */
     int NumIter;
+    /** @brief Convergence tolerance, zero to always perform NumIter */
+    float Tol;
+    /** @brief Display the change and time of each iteration */
+    int ShowIterations;
+    /** @brief Number of threads */
+    int NumThreads;
 } programparams;
 
 
@@ -69,6 +75,12 @@ static void PrintHelpMessage()
     printf("                 bilinear    simple bilinear interpolation\n");
     printf("                 input       input file is used as initial demosaicing\n");
     printf("   -n <number>   number of POCS iterations to perform (default 8)\n");
+    printf("   -t <number>   convergence tolerance, stop before n iterations\n"
+        "                 if the relative L2 change is at most this (default 0,\n"
+        "                 always perform n iterations)\n");
+    printf("   -v            Display the change and time of each iteration.\n");
+    printf("   -j <number>   number of threads (default 1), requires a build\n"
+        "                 with OpenMP, the output does not depend on it\n");
 #ifdef LIBJPEG_SUPPORT
     printf("   -q <number>   Quality for saving JPEG images (0 to 100)\n\n");
 #endif
@@ -175,7 +187,8 @@ int main(int argc, char *argv[])
        
     /* Perform Gunturk demosaicing */
     if(!(GunturkDemosaic(Image, Width, Height, 
-        Param.RedX, Param.RedY, Param.NumIter)))
+        Param.RedX, Param.RedY, Param.NumIter, 
+        Param.Tol, Param.ShowIterations, Param.NumThreads)))
         goto Catch;
     
     /* Write the output image */
@@ -217,6 +230,9 @@ static int ParseParams(programparams *Param, int argc, char *argv[])
     Param->RedX = 0;
     Param->RedY = 0;    
     Param->NumIter = 8;
+    Param->Tol = 0;
+    Param->ShowIterations = 0;
+    Param->NumThreads = 1;
     
     for(i = 1; i < argc;)
     {
@@ -279,6 +295,28 @@ static int ParseParams(programparams *Param, int argc, char *argv[])
                     return 0;
                 }
                 break;
+            case 't':
+                Param->Tol = (float)atof(OptionString);
+
+                if(Param->Tol < 0)
+                {
+                    ErrorMessage("Tolerance must be nonnegative.\n");
+                    return 0;
+                }
+                break;
+            case 'v':
+                Param->ShowIterations = 1;
+                i--;
+                break;
+            case 'j':
+                Param->NumThreads = atoi(OptionString);
+
+                if(Param->NumThreads <= 0)
+                {
+                    ErrorMessage("Number of threads must be positive.\n");
+                    return 0;
+                }
+                break;
             case 'i':
                 Param->Initialization = OptionString;
                 break;                
@@ -33,7 +33,435 @@
 
 #include <math.h>
 #include "basic.h"
-#include "dmbilinear.h"
+#include "dmha.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+/** @brief Green interpolation uses 8-lane AVX vectors */
+#define HA_VECTOR_AVX
+#elif defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+/** @brief Green interpolation uses 4-lane SSE2 vectors */
+#define HA_VECTOR_SSE2
+#endif
+
+
+/**
+ * @brief Bilinear green interpolation at one red or blue border pixel
+ * @param Input pointer to the pixel in the input image
+ * @param Width, Height the image dimensions
+ * @param x, y the pixel coordinates
+ * @return the interpolated green value
+ *
+ * The neighbors are summed in the same order as in BilinearDemosaic so 
+ * that the border agrees exactly with bilinear demosaicing.
+ */
+static float HamiltonAdamsBorderGreen(const float *Input, 
+    int Width, int Height, int x, int y)
+{
+    float Sum = 0;
+    int Count = 0;
+    
+    
+    if(x > 0 && x < Width - 1 && y > 0 && y < Height - 1)
+        return ((Input[-1] + Input[1])/2 
+            + (Input[-Width] + Input[Width])/2)/2;
+    
+    if(x > 0)
+    {
+        Sum += Input[-1];
+        Count++;
+    }
+    if(x < Width - 1)
+    {
+        Sum += Input[1];
+        Count++;
+    }
+    if(y > 0)
+    {
+        Sum += Input[-Width];
+        Count++;
+    }
+    if(y < Height - 1)
+    {
+        Sum += Input[Width];
+        Count++;
+    }
+    
+    return Sum / Count;
+}
+
+
+/**
+ * @brief Hamilton-Adams green interpolation at one red or blue pixel
+ * @param Input pointer to the pixel in the input image
+ * @param Width the image width
+ * @param Threshold threshold for deciding that the variations are equal
+ * @return the interpolated green value
+ */
+static ATTRIBUTE_ALWAYSINLINE float HamiltonAdamsGreen(const float *Input,
+    int Width, float Threshold)
+{
+    const int Width2 = Width*2;
+    float VariationH, VariationV;
+    
+    
+    VariationH = (float)(fabs(Input[-2] - 2*Input[0] + Input[2])
+        + fabs(Input[-1] - Input[1]));
+    VariationV = (float)(fabs(Input[-Width2] - 2*Input[0] + Input[Width2])
+        + fabs(Input[-Width] - Input[Width]));
+
+    if(fabs(VariationH - VariationV) < Threshold)
+        return (4*Input[0]
+            + 2*(Input[-Width] + Input[Width] + Input[-1] + Input[1])
+            - Input[-Width2] - Input[Width2] - Input[-2] - Input[2]) / 8;
+    else if(VariationH < VariationV)
+        return (2*(Input[-1] + Input[0] + Input[1])
+            - Input[-2] - Input[2]) / 4;
+    else
+        return (2*(Input[-Width] + Input[0] + Input[Width])
+            - Input[-Width2] - Input[Width2]) / 4;
+}
+
+
+#if defined(HA_VECTOR_AVX) || defined(HA_VECTOR_SSE2)
+
+#ifdef HA_VECTOR_AVX
+#define vfloat                  __m256
+#define VLANES                  8
+#define VLOAD(p)                _mm256_loadu_ps(p)
+#define VSTORE(p, a)            _mm256_storeu_ps(p, a)
+#define VSET1(c)                _mm256_set1_ps(c)
+#define VADD(a, b)              _mm256_add_ps(a, b)
+#define VSUB(a, b)              _mm256_sub_ps(a, b)
+#define VMUL(a, b)              _mm256_mul_ps(a, b)
+#define VABS(a)                 _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a)
+#define VCMPLT(a, b)            _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define VSELECT(m, a, b)        _mm256_blendv_ps(b, a, m)
+#define VMASK_EVEN  _mm256_castsi256_ps(_mm256_set_epi32(0,-1,0,-1,0,-1,0,-1))
+#define VMASK_ODD   _mm256_castsi256_ps(_mm256_set_epi32(-1,0,-1,0,-1,0,-1,0))
+#else
+#define vfloat                  __m128
+#define VLANES                  4
+#define VLOAD(p)                _mm_loadu_ps(p)
+#define VSTORE(p, a)            _mm_storeu_ps(p, a)
+#define VSET1(c)                _mm_set1_ps(c)
+#define VADD(a, b)              _mm_add_ps(a, b)
+#define VSUB(a, b)              _mm_sub_ps(a, b)
+#define VMUL(a, b)              _mm_mul_ps(a, b)
+#define VABS(a)                 _mm_andnot_ps(_mm_set1_ps(-0.0f), a)
+#define VCMPLT(a, b)            _mm_cmplt_ps(a, b)
+#define VSELECT(m, a, b)        _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#define VMASK_EVEN  _mm_castsi128_ps(_mm_set_epi32(0,-1,0,-1))
+#define VMASK_ODD   _mm_castsi128_ps(_mm_set_epi32(-1,0,-1,0))
+#endif
+
+/**
+ * @brief Vectorized Hamilton-Adams green interpolation on a row segment
+ * @param OutputGreen output green row
+ * @param Input input row
+ * @param Width the image width
+ * @param x the starting column, must be even
+ * @param xEnd one past the last column to compute
+ * @param Col the column parity (0 or 1) of the non-green pixels in this row
+ * @param Threshold threshold for deciding that the variations are equal
+ * @return the first column that was not computed
+ *
+ * Every lane computes both variations and all three candidate estimates,
+ * then the decision of HamiltonAdamsGreen is made with compare masks.
+ * Green lanes are passed through from the input.  The arithmetic follows
+ * HamiltonAdamsGreen operation by operation so that the result is 
+ * identical to the scalar path.
+ */
+static ATTRIBUTE_ALWAYSINLINE int HamiltonAdamsRowVector(float *OutputGreen,
+    const float *Input, int Width, int x, int xEnd, int Col, 
+    float Threshold)
+{
+    const vfloat Two = VSET1(2.0f), Four = VSET1(4.0f);
+    const vfloat OneQuarter = VSET1(0.25f), OneEighth = VSET1(0.125f);
+    const vfloat Thresh = VSET1(Threshold);
+    const vfloat NonGreen = (Col) ? VMASK_ODD : VMASK_EVEN;
+    const float *Up = Input - Width, *Up2 = Input - 2*Width;
+    const float *Down = Input + Width, *Down2 = Input + 2*Width;
+    vfloat Center, Left, Right, Left2, Right2, U, D, U2, D2;
+    vfloat VariationH, VariationV, IsoGreen, HGreen, VGreen, Green;
+    
+    
+    for(; x + VLANES <= xEnd; x += VLANES)
+    {
+        Center = VLOAD(Input + x);
+        Left = VLOAD(Input + x - 1);
+        Right = VLOAD(Input + x + 1);
+        Left2 = VLOAD(Input + x - 2);
+        Right2 = VLOAD(Input + x + 2);
+        U = VLOAD(Up + x);
+        D = VLOAD(Down + x);
+        U2 = VLOAD(Up2 + x);
+        D2 = VLOAD(Down2 + x);
+        
+        VariationH = VADD(VABS(VADD(VSUB(Left2, VMUL(Two, Center)), Right2)),
+            VABS(VSUB(Left, Right)));
+        VariationV = VADD(VABS(VADD(VSUB(U2, VMUL(Two, Center)), D2)),
+            VABS(VSUB(U, D)));
+        
+        IsoGreen = VMUL(VSUB(VSUB(VSUB(VSUB(VADD(VMUL(Four, Center), 
+            VMUL(Two, VADD(VADD(VADD(U, D), Left), Right))), 
+            U2), D2), Left2), Right2), OneEighth);
+        HGreen = VMUL(VSUB(VSUB(VMUL(Two, VADD(VADD(Left, Center), Right)),
+            Left2), Right2), OneQuarter);
+        VGreen = VMUL(VSUB(VSUB(VMUL(Two, VADD(VADD(U, Center), D)),
+            U2), D2), OneQuarter);
+        
+        Green = VSELECT(VCMPLT(VariationH, VariationV), HGreen, VGreen);
+        Green = VSELECT(VCMPLT(VABS(VSUB(VariationH, VariationV)), Thresh),
+            IsoGreen, Green);
+        VSTORE(OutputGreen + x, VSELECT(NonGreen, Green, Center));
+    }
+    
+    return x;
+}
+
+#endif /* HA_VECTOR_AVX || HA_VECTOR_SSE2 */
+
+
+/**
+ * @brief Hamilton-Adams green interpolation on one interior row
+ * @param OutputGreen output green row
+ * @param Input input row
+ * @param Width the image width
+ * @param Col the column parity (0 or 1) of the non-green pixels in this row
+ * @param Threshold threshold for deciding that the variations are equal
+ *
+ * Computes columns 2 to Width - 3.  The bulk of the row is done with
+ * vector instructions when available, and the remaining columns with a
+ * loop unrolled over the two pixels of a CFA period.
+ */
+static ATTRIBUTE_ALWAYSINLINE void HamiltonAdamsRow(float *OutputGreen,
+    const float *Input, int Width, int Col, float Threshold)
+{
+    int x = 2;
+    
+    
+#if defined(HA_VECTOR_AVX) || defined(HA_VECTOR_SSE2)
+    x = HamiltonAdamsRowVector(OutputGreen, Input, Width, x, Width - 2, 
+        Col, Threshold);
+#endif
+    
+    for(; x + 1 < Width - 2; x += 2)
+    {
+        OutputGreen[x + Col] = HamiltonAdamsGreen(Input + x + Col,
+            Width, Threshold);
+        OutputGreen[x + 1 - Col] = Input[x + 1 - Col];
+    }
+    
+    if(x < Width - 2)
+        OutputGreen[x] = (Col) ? Input[x] 
+            : HamiltonAdamsGreen(Input + x, Width, Threshold);
+}
+
+
+/**
+ * @brief Interpolate green on one row
+ * @param OutputGreen output green row
+ * @param Input input row
+ * @param Width, Height the image dimensions
+ * @param y the row index
+ * @param Col the column parity (0 or 1) of the non-green pixels in this row
+ * @param Threshold threshold for deciding that the variations are equal
+ *
+ * Pixels within two pixels of the border use bilinear interpolation, all 
+ * others use Hamilton-Adams.
+ */
+static void HamiltonAdamsGreenRow(float *OutputGreen, const float *Input,
+    int Width, int Height, int y, int Col, float Threshold)
+{
+    int x, xEnd;
+    
+    
+    if(y < 2 || y >= Height - 2 || Width < 5)
+        xEnd = Width;
+    else
+    {
+        xEnd = 2;
+        
+        if(Col)
+            HamiltonAdamsRow(OutputGreen, Input, Width, 1, Threshold);
+        else
+            HamiltonAdamsRow(OutputGreen, Input, Width, 0, Threshold);
+        
+        for(x = Width - 2; x < Width; x++)
+            OutputGreen[x] = ((x & 1) == Col) ? HamiltonAdamsBorderGreen(
+                Input + x, Width, Height, x, y) : Input[x];
+    }
+    
+    for(x = 0; x < xEnd; x++)
+        OutputGreen[x] = ((x & 1) == Col) ? HamiltonAdamsBorderGreen(
+            Input + x, Width, Height, x, y) : Input[x];
+}
+
+
+/**
+ * @brief Bilinear interpolation of color differences at one border pixel
+ * @param OutputRed, OutputBlue pointers to the pixel in the output planes
+ * @param Green the interpolated green value at the pixel
+ * @param DiffUp, Diff, DiffDown pointers to the pixel in the difference 
+ *    rows above, at, and below, DiffUp or DiffDown is NULL if outside
+ * @param Width the image width
+ * @param x the column index
+ * @param IsRedRow nonzero if the row contains red pixels
+ * @param IsGreen nonzero if the pixel is a green pixel
+ *
+ * The available neighbors are averaged in the same order as in 
+ * BilinearDifference so that the border agrees exactly.
+ */
+static void HamiltonAdamsDiffPixel(float *OutputRed, float *OutputBlue,
+    float Green, const float *DiffUp, const float *Diff, 
+    const float *DiffDown, int Width, int x, int IsRedRow, int IsGreen)
+{
+    const int HasLeft = (x > 0), HasRight = (x < Width - 1);
+    float AverageH, AverageV, AverageX;
+    int Count;
+    
+    
+    if(IsGreen)
+    {
+        AverageH = (HasLeft && HasRight) ? (Diff[-1] + Diff[1])/2 
+            : ((HasLeft) ? Diff[-1] : Diff[1]);
+        AverageV = (DiffUp && DiffDown) ? (DiffUp[0] + DiffDown[0])/2
+            : ((DiffUp) ? DiffUp[0] : DiffDown[0]);
+        
+        *OutputRed = Green + ((IsRedRow) ? AverageH : AverageV);
+        *OutputBlue = Green + ((IsRedRow) ? AverageV : AverageH);
+    }
+    else
+    {
+        AverageX = 0;
+        Count = 0;
+        
+        if(DiffUp)
+        {
+            if(HasLeft)
+            {
+                AverageX += DiffUp[-1];
+                Count++;
+            }
+            if(HasRight)
+            {
+                AverageX += DiffUp[1];
+                Count++;
+            }
+        }
+        if(DiffDown)
+        {
+            if(HasLeft)
+            {
+                AverageX += DiffDown[-1];
+                Count++;
+            }
+            if(HasRight)
+            {
+                AverageX += DiffDown[1];
+                Count++;
+            }
+        }
+        
+        AverageX /= Count;
+        *OutputRed = Green + ((IsRedRow) ? Diff[0] : AverageX);
+        *OutputBlue = Green + ((IsRedRow) ? AverageX : Diff[0]);
+    }
+}
+
+
+/**
+ * @brief Bilinear interpolation of color differences on one interior row
+ * @param Own output row for the color of the non-green pixels in this row
+ * @param Green interpolated green row
+ * @param Other output row for the other color
+ * @param DiffUp, Diff, DiffDown difference rows above, at, and below
+ * @param Width the image width
+ * @param Col the column parity (0 or 1) of the non-green pixels in this row
+ *
+ * Computes columns 1 to Width - 2 with the formulas of BilinearDifference.
+ */
+static ATTRIBUTE_ALWAYSINLINE void HamiltonAdamsDiffRow(float *Own, 
+    const float *Green, float *Other, const float *DiffUp, 
+    const float *Diff, const float *DiffDown, int Width, int Col)
+{
+    int x, xOwn, xGreen;
+    
+    
+    for(x = 1; x + 1 < Width - 1; x += 2)
+    {
+        xOwn = x + 1 - Col;
+        xGreen = x + Col;
+        
+        Own[xOwn] = Green[xOwn] + Diff[xOwn];
+        Other[xOwn] = Green[xOwn] + (DiffUp[xOwn - 1] + DiffUp[xOwn + 1]
+            + DiffDown[xOwn - 1] + DiffDown[xOwn + 1])/4;
+        Own[xGreen] = Green[xGreen] + (Diff[xGreen - 1] 
+            + Diff[xGreen + 1])/2;
+        Other[xGreen] = Green[xGreen] + (DiffUp[xGreen] 
+            + DiffDown[xGreen])/2;
+    }
+    
+    if(x < Width - 1)
+    {
+        if((x & 1) == Col)
+        {
+            Own[x] = Green[x] + Diff[x];
+            Other[x] = Green[x] + (DiffUp[x - 1] + DiffUp[x + 1]
+                + DiffDown[x - 1] + DiffDown[x + 1])/4;
+        }
+        else
+        {
+            Own[x] = Green[x] + (Diff[x - 1] + Diff[x + 1])/2;
+            Other[x] = Green[x] + (DiffUp[x] + DiffDown[x])/2;
+        }
+    }
+}
+
+
+/**
+ * @brief Interpolate red and blue on one row from the color differences
+ * @param OutputRed, OutputBlue output red and blue rows
+ * @param Green interpolated green row
+ * @param DiffUp, Diff, DiffDown difference rows above, at, and below,
+ *    DiffUp or DiffDown is NULL if outside the image
+ * @param Width the image width
+ * @param Col the column parity (0 or 1) of the non-green pixels in this row
+ * @param IsRedRow nonzero if the row contains red pixels
+ */
+static void HamiltonAdamsRedBlueRow(float *OutputRed, float *OutputBlue,
+    const float *Green, const float *DiffUp, const float *Diff, 
+    const float *DiffDown, int Width, int Col, int IsRedRow)
+{
+    float *Own = (IsRedRow) ? OutputRed : OutputBlue;
+    float *Other = (IsRedRow) ? OutputBlue : OutputRed;
+    int x;
+    
+    
+    if(DiffUp && DiffDown && Width >= 3)
+    {
+        if(Col)
+            HamiltonAdamsDiffRow(Own, Green, Other, 
+                DiffUp, Diff, DiffDown, Width, 1);
+        else
+            HamiltonAdamsDiffRow(Own, Green, Other, 
+                DiffUp, Diff, DiffDown, Width, 0);
+        
+        for(x = 0; x < Width; x += Width - 1)
+            HamiltonAdamsDiffPixel(OutputRed + x, OutputBlue + x, Green[x],
+                DiffUp + x, Diff + x, DiffDown + x, Width, x, IsRedRow, 
+                (x & 1) != Col);
+    }
+    else
+        for(x = 0; x < Width; x++)
+            HamiltonAdamsDiffPixel(OutputRed + x, OutputBlue + x, Green[x],
+                (DiffUp) ? DiffUp + x : NULL, Diff + x, 
+                (DiffDown) ? DiffDown + x : NULL, Width, x, IsRedRow, 
+                (x & 1) != Col);
+}
 
 
 /** 
@@ -42,69 +470,64 @@
  * @param Input the input image
  * @param Width, Height the image dimensions
  * @param RedX, RedY the coordinates of the upper-rightmost red pixel
+ * @param Threshold threshold for deciding that the horizontal and vertical
+ *    variations are equal, 2/255 is a good choice for data in [0,1] and
+ *    it should scale with the data range (e.g., about 514 for 16-bit data)
+ * @return 1 on success, 0 on failure
  *
  * The Input image is a 2D float array of the input RGB values of size 
  * Width*Height in row-major order.  RedX, RedY are the coordinates of the 
  * upper-rightmost red pixel to specify the CFA pattern.
+ *
+ * The image is processed in a single pass over the rows.  Green for row 
+ * y + 1 is interpolated first, its (Input - Green) difference is put in a 
+ * ring buffer of three rows, and then red and blue for row y are 
+ * interpolated from the differences of rows y - 1, y, and y + 1.  Pixels 
+ * near the border use bilinear interpolation.  Only the three-row buffer 
+ * is allocated.
  */
 int HamiltonAdamsDemosaic(float *Output, const float *Input, 
-    int Width, int Height, int RedX, int RedY)
+    int Width, int Height, int RedX, int RedY, float Threshold)
 {
-    const float Threshold = 2/255.0f;
-    const int Green = 1 - ((RedX + RedY) & 1);
-    const int Width2 = Width*2;
     const int NumPixels = Width*Height;
+    float *OutputRed = Output;
     float *OutputGreen = Output + NumPixels;
-    float *Diff = NULL;
-    float VariationH, VariationV;
-    int i, x, y;
+    float *OutputBlue = Output + 2*NumPixels;
+    float *Ring = NULL;
+    const float *DiffUp, *DiffDown;
+    int i, x, y, Col;
 
     
-    if(!(Diff = (float *)Malloc(sizeof(float)*NumPixels)))
+    if(!(Ring = (float *)Malloc(sizeof(float)*3*Width)))
         return 0;
     
-    /* Use bilinear demosaicing to interpolate pixels near the borders */
-    BilinearDemosaic(Output, Input, Width, Height, RedX, RedY);
-
-    for(y = 2; y < Height - 2; y++)
-        for(x = 2; x < Width - 2; x++)
+    for(y = 0; y <= Height; y++)
+    {
+        if(y < Height)
         {
-            i = x + Width*y;
+            /* Interpolate green on row y and store its differences */
+            i = Width*y;
+            Col = ((y & 1) == RedY) ? RedX : 1 - RedX;
+            HamiltonAdamsGreenRow(OutputGreen + i, Input + i, 
+                Width, Height, y, Col, Threshold);
             
-            if(((x + y) & 1) != Green)
-            {
-                VariationH = (float)(fabs(Input[i - 2]
-                    - 2*Input[i] + Input[i + 2])
-                    + fabs(Input[i - 1] - Input[i + 1]));
-                VariationV = (float)(fabs(Input[i - Width*2]
-                    - 2*Input[i] + Input[i + Width*2])
-                    + fabs(Input[i - Width] - Input[i + Width]));
-
-                if(fabs(VariationH - VariationV) < Threshold)
-                    OutputGreen[i] = (4*Input[i]
-                        + 2*(Input[i - Width] + Input[i + Width]
-                        + Input[i - 1] + Input[i + 1])
-                        - Input[i - Width2] - Input[i + Width2]
-                        - Input[i - 2] - Input[i + 2]) / 8;
-                else if(VariationH < VariationV)
-                    OutputGreen[i] = 
-                        (2*(Input[i - 1] + Input[i] + Input[i + 1])
-                        - Input[i - 2] - Input[i + 2]) / 4;
-                else
-                    OutputGreen[i] = 
-                        (2*(Input[i - Width] + Input[i] + Input[i + Width])
-                        - Input[i - Width2] - Input[i + Width2]) / 4;
-            }
-            else
-                OutputGreen[i] = Input[i];
+            for(x = 0; x < Width; x++)
+                Ring[Width*(y % 3) + x] = Input[i + x] - OutputGreen[i + x];
         }
+        
+        if(y > 0)
+        {
+            /* Interpolate red and blue on row y - 1 */
+            i = Width*(y - 1);
+            Col = (((y - 1) & 1) == RedY) ? RedX : 1 - RedX;
+            DiffUp = (y >= 2) ? Ring + Width*((y - 2) % 3) : NULL;
+            DiffDown = (y < Height) ? Ring + Width*(y % 3) : NULL;
+            HamiltonAdamsRedBlueRow(OutputRed + i, OutputBlue + i,
+                OutputGreen + i, DiffUp, Ring + Width*((y - 1) % 3), 
+                DiffDown, Width, Col, ((y - 1) & 1) == RedY);
+        }
+    }
     
-    for(i = 0; i < NumPixels; i++)
-        Diff[i] = Input[i] - OutputGreen[i];
-    
-    /* Bilinearly interpolate (Red - Green) and (Blue - Green) differences */
-    BilinearDifference(Output, Diff, Width, Height, RedX, RedY);
-    
-    Free(Diff);
+    Free(Ring);
     return 1;
 }
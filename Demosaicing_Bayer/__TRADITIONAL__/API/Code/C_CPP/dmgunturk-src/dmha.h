@@ -18,6 +18,6 @@
 #define _DMHA_H_
 
 int HamiltonAdamsDemosaic(float *Output, const float *Input, 
-    int Width, int Height, int RedX, int RedY);
+    int Width, int Height, int RedX, int RedY, float Threshold);
 
 #endif /* _DMHA_H_ */
@@ -41,6 +41,8 @@ typedef struct
     int RedX;
     /** @brief CFA pattern upperleftmost red pixel y-coordinate */
     int RedY;
+    /** @brief Threshold for deciding that the variations are equal */
+    float Threshold;
 } programparams;
 
 
@@ -60,6 +62,8 @@ static void PrintHelpMessage()
     printf("                 GRBG        upperleftmost red pixel is at (1,0)\n");
     printf("                 GBRG        upperleftmost red pixel is at (0,1)\n");
     printf("                 BGGR        upperleftmost red pixel is at (1,1)\n");
+    printf("   -t <number>   Threshold for equal variations, in units where\n"
+        "                 the image range is [0,1] (default 2/255)\n");
 #ifdef LIBJPEG_SUPPORT
     printf("   -q <number>   Quality for saving JPEG images (0 to 100)\n\n");
 #endif
@@ -98,7 +102,7 @@ int main(int argc, char *argv[])
     
     /* Perform demosaicing */
     if(!(HamiltonAdamsDemosaic(Output, Input, Width, Height, 
-        Param.RedX, Param.RedY)))
+        Param.RedX, Param.RedY, Param.Threshold)))
         goto Catch;
     
     /* Write the output image */
@@ -134,6 +138,7 @@ static int ParseParams(programparams *Param, int argc, char *argv[])
     Param->JpegQuality = 80;
     Param->RedX = 0;
     Param->RedY = 0;
+    Param->Threshold = 2/255.0f;
     
     for(i = 1; i < argc;)
     {
@@ -185,6 +190,15 @@ static int ParseParams(programparams *Param, int argc, char *argv[])
                 else
                     ErrorMessage("CFA pattern must be RGGB, GRBG, GBRG, or BGGR\n");
                 break;
+            case 't':
+                Param->Threshold = (float)atof(OptionString);
+
+                if(Param->Threshold < 0)
+                {
+                    ErrorMessage("Threshold must be nonnegative.\n");
+                    return 0;
+                }
+                break;
 #ifdef LIBJPEG_SUPPORT
             case 'q':
                 Param->JpegQuality = atoi(OptionString);
@@ -0,0 +1,427 @@
+/**
+ * @file dmonestep.c
+ * @brief One-step polyphase implementation of Gunturk demosaicing
+ * @author Demosaicing_Bayer contributors
+ *
+ * The alternating projections of Gunturk et al. are linear in the color
+ * differences once the green channel is fixed, so a given number of
+ * iterations is equivalent to applying a set of polyphase filters to the
+ * differences on the four sublattices of the Bayer pattern (Y. M. Lu,
+ * M. Karzand, M. Vetterli, "Demosaicking by Alternating Projections:
+ * Theory and Fast One-Step Implementation," IEEE Trans. Image Processing,
+ * 2010).  This file implements the "partial convergence" method of the
+ * MATLAB code onestep_demosaicking_part.m with the separable filters from
+ * onestepfilters.c.
+ *
+ *
+ * Copyright (c) 2026, Demosaicing_Bayer contributors
+ * All rights reserved.
+ *
+ * This program is free software: you can use, modify and/or
+ * redistribute it under the terms of the simplified BSD License. You
+ * should have received a copy of this license along this program. If
+ * not, see <http://www.opensource.org/licenses/bsd-license.html>.
+ */
+
+#include "basic.h"
+#include "conv.h"
+#include "onestepfilters.h"
+
+
+/** @brief Clamp a value to the interval [0,1] */
+#define CLAMP01(X)  (((X) < 0) ? 0 : (((X) > 1) ? 1 : (X)))
+
+
+/** @brief Whole-sample symmetric boundary extension of an index */
+static int SymwIndex(int n, int N)
+{
+    while(1)
+    {
+        if(n < 0)
+            n = -n;
+        else if(n >= N)
+            n = 2*(N - 1) - n;
+        else
+            return n;
+    }
+}
+
+
+/** @brief Clamp an index to [0, N - 1] */
+static int ClampIndex(int n, int N)
+{
+    return (n < 0) ? 0 : ((n >= N) ? N - 1 : n);
+}
+
+
+/**
+ * @brief Edge-sensitive interpolation of green at a red or blue pixel
+ * @param Mosaic the mosaiced image
+ * @param Width, Height the image dimensions
+ * @param x, y the pixel location
+ * @return the estimated green value
+ *
+ * This is the interpolation of esi_g.m.  Pixels near the boundary use
+ * whole-sample symmetric extension, which preserves the CFA pattern.
+ */
+static float EsiGreen(const float *Mosaic, int Width, int Height,
+    int x, int y)
+{
+    const float *Center = Mosaic + x + Width*y;
+    float DiffH, DiffV, DeltaH, DeltaV;
+    int Left1, Left2, Right1, Right2, Up1, Up2, Down1, Down2;
+
+
+    if(x >= 2 && x < Width - 2)
+    {
+        Left1 = -1;
+        Left2 = -2;
+        Right1 = 1;
+        Right2 = 2;
+    }
+    else
+    {
+        Left1 = SymwIndex(x - 1, Width) - x;
+        Left2 = SymwIndex(x - 2, Width) - x;
+        Right1 = SymwIndex(x + 1, Width) - x;
+        Right2 = SymwIndex(x + 2, Width) - x;
+    }
+
+    if(y >= 2 && y < Height - 2)
+    {
+        Up1 = -Width;
+        Up2 = -2*Width;
+        Down1 = Width;
+        Down2 = 2*Width;
+    }
+    else
+    {
+        Up1 = Width*(SymwIndex(y - 1, Height) - y);
+        Up2 = Width*(SymwIndex(y - 2, Height) - y);
+        Down1 = Width*(SymwIndex(y + 1, Height) - y);
+        Down2 = Width*(SymwIndex(y + 2, Height) - y);
+    }
+
+    DiffH = 2*Center[0] - Center[Left2] - Center[Right2];
+    DeltaH = (float)fabs(Center[Left1] - Center[Right1]) + (float)fabs(DiffH);
+    DiffV = 2*Center[0] - Center[Down2] - Center[Up2];
+    DeltaV = (float)fabs(Center[Up1] - Center[Down1]) + (float)fabs(DiffV);
+
+    if(DeltaV > DeltaH)
+        return (Center[Left1] + Center[Right1])/2 + DiffH/4;
+    else if(DeltaV < DeltaH)
+        return (Center[Up1] + Center[Down1])/2 + DiffV/4;
+    else
+        return (Center[Left1] + Center[Right1] + Center[Up1]
+            + Center[Down1])/4 + (DiffH + DiffV)/8;
+}
+
+
+/**
+ * @brief Extract one sublattice of a GRBG mosaic
+ * @param Dest the QWidth by QHeight sublattice
+ * @param Mosaic the mosaiced image, of size 2*QWidth by 2*QHeight
+ * @param PhaseX, PhaseY the sublattice offset (0 or 1)
+ * @param QWidth, QHeight the sublattice dimensions
+ */
+static void ExtractPhase(float *Dest, const float *Mosaic,
+    int PhaseX, int PhaseY, int QWidth, int QHeight)
+{
+    const int Width = 2*QWidth;
+    int i, j;
+
+    for(i = 0; i < QHeight; i++)
+        for(j = 0; j < QWidth; j++)
+            Dest[j + QWidth*i] = Mosaic[2*j + PhaseX + Width*(2*i + PhaseY)];
+}
+
+
+/**
+ * @brief Write one sublattice to a channel of the output image
+ * @param Output the output channel
+ * @param Width, Height the output dimensions
+ * @param Src the sublattice
+ * @param QWidth, QHeight the sublattice dimensions
+ * @param OffsetX, OffsetY position in Output of the sublattice origin
+ *
+ * Samples falling outside of the output image are skipped.
+ */
+static void ScatterPhase(float *Output, int Width, int Height,
+    const float *Src, int QWidth, int QHeight, int OffsetX, int OffsetY)
+{
+    int i, j, x, y;
+
+    for(i = 0; i < QHeight; i++)
+    {
+        y = 2*i + OffsetY;
+
+        if(y < 0 || y >= Height)
+            continue;
+
+        for(j = 0; j < QWidth; j++)
+        {
+            x = 2*j + OffsetX;
+
+            if(0 <= x && x < Width)
+                Output[x + Width*y] = Src[j + QWidth*i];
+        }
+    }
+}
+
+
+/**
+ * @brief Refine the green estimate on a red or blue sublattice
+ * @param Green on input the initial green estimate, on output the refined
+ *    estimate clamped to [0,1]
+ * @param Raw the observed red or blue sublattice
+ * @param Diff, Buffer workspace arrays of size QWidth*QHeight
+ * @param Boundary boundary extension
+ * @param QWidth, QHeight the sublattice dimensions
+ *
+ * The green estimate is replaced by Raw + LL*(Green - Raw), where LL is
+ * the separable lowpass filter of the subband decomposition.
+ */
+static void RefineGreen(float *Green, const float *Raw, float *Diff,
+    float *Buffer, boundaryext Boundary, int QWidth, int QHeight)
+{
+    static float LCoeff[7] = {-1.0f/32, 0, 9.0f/32, 16.0f/32, 9.0f/32,
+        0, -1.0f/32};
+    const filter L = MakeFilter(LCoeff, -3, 7);
+    const long QNumPixels = ((long)QWidth)*((long)QHeight);
+    long i;
+
+    for(i = 0; i < QNumPixels; i++)
+        Diff[i] = Green[i] - Raw[i];
+
+    SeparableConv2D(Green, Buffer, Diff, L, L, Boundary, QWidth, QHeight, 1);
+
+    for(i = 0; i < QNumPixels; i++)
+    {
+        Green[i] += Raw[i];
+        Green[i] = CLAMP01(Green[i]);
+    }
+}
+
+
+/**
+ * @brief Apply one row of polyphase filters
+ * @param Dest output sublattice
+ * @param Diff the four color difference sublattices
+ * @param Filters the four filters to apply to Diff
+ * @param Green the green sublattice to add to the result
+ * @param Temp, Buffer workspace arrays of size QWidth*QHeight
+ * @param Boundary boundary extension
+ * @param QWidth, QHeight the sublattice dimensions
+ *
+ * Computes Dest = Green + sum_c Filters[c] * Diff[c], clamped to [0,1].
+ * Filters with all zero coefficients are skipped.
+ */
+static void ApplyPolyphase(float *Dest, float **Diff,
+    const onestepfilter *Filters, const float *Green, float *Temp,
+    float *Buffer, boundaryext Boundary, int QWidth, int QHeight)
+{
+    const long QNumPixels = ((long)QWidth)*((long)QHeight);
+    filter FilterX, FilterY;
+    long i;
+    int c, k;
+
+    for(i = 0; i < QNumPixels; i++)
+        Dest[i] = 0;
+
+    for(c = 0; c < 4; c++)
+    {
+        for(k = 0; k < ONESTEP_TAPS; k++)
+            if(Filters[c].Horiz[k] != 0)
+                break;
+
+        if(k == ONESTEP_TAPS)
+            continue;
+
+        FilterX = MakeFilter((float *)Filters[c].Horiz,
+            ONESTEP_DELAY, ONESTEP_TAPS);
+        FilterY = MakeFilter((float *)Filters[c].Vert,
+            ONESTEP_DELAY, ONESTEP_TAPS);
+        SeparableConv2D(Temp, Buffer, Diff[c], FilterX, FilterY,
+            Boundary, QWidth, QHeight, 1);
+
+        for(i = 0; i < QNumPixels; i++)
+            Dest[i] += Temp[i];
+    }
+
+    for(i = 0; i < QNumPixels; i++)
+    {
+        Dest[i] += Green[i];
+        Dest[i] = CLAMP01(Dest[i]);
+    }
+}
+
+
+/**
+ * @brief One-step polyphase Gunturk demosaicing
+ * @param Output pointer to memory to store the demosaiced image
+ * @param Input the input image as a flattened 2D array
+ * @param Width, Height the image dimensions
+ * @param RedX, RedY the coordinates of the upper-rightmost red pixel
+ * @param NumIter number of Gunturk iterations to emulate
+ * @return 1 on success, 0 on failure
+ *
+ * The result approximates NumIter iterations of Gunturk demosaicing
+ * initialized with edge-sensitive interpolation, computed in a single
+ * pass of separable 6x6 FIR filters.  Filters are precomputed for the
+ * numbers of iterations listed by PrintOneStepIterChoices.
+ *
+ * The image is extended with whole-sample symmetry so that it has even
+ * dimensions and a GRBG pattern, the layout the filters are designed for.
+ * The filters are then applied on the quarter-resolution sublattices
+ *    G00 (green on red rows)    R01 (red)
+ *    B10 (blue)                 G11 (green on blue rows)
+ * The output is in planar row-major order with channels red, green, blue.
+ */
+int OneStepDemosaic(float *Output, const float *Input,
+    int Width, int Height, int RedX, int RedY, int NumIter)
+{
+    const int PadWidth = 2*((Width + 2 - RedX)/2);
+    const int PadHeight = 2*((Height + 1 + RedY)/2);
+    const int QWidth = PadWidth/2, QHeight = PadHeight/2;
+    const long NumPixels = ((long)Width)*((long)Height);
+    const long QNumPixels = ((long)QWidth)*((long)QHeight);
+    const int OffsetX = RedX - 1, OffsetY = -RedY;
+    boundaryext Boundary = GetBoundaryExt("symw");
+    const onestepfilterbank *Bank;
+    float *Mosaic = NULL, *G00, *R01, *B10, *G11, *Green01, *Green10;
+    float *Diff[4], *Result, *Temp, *Buffer;
+    int i, j, i0, i1, j0, j1, Success = 0;
+
+
+    if(!(Bank = GetOneStepFilters(NumIter)))
+    {
+        ErrorMessage("No precomputed filters for %d iterations.\n", NumIter);
+        return 0;
+    }
+    else if(!(Mosaic = (float *)Malloc(sizeof(float)*17*QNumPixels)))
+        goto Catch;
+
+    G00 = Mosaic + 4*QNumPixels;
+    R01 = G00 + QNumPixels;
+    B10 = R01 + QNumPixels;
+    G11 = B10 + QNumPixels;
+    Green01 = G11 + QNumPixels;
+    Green10 = Green01 + QNumPixels;
+    Diff[0] = Green10 + QNumPixels;
+    Diff[1] = Diff[0] + QNumPixels;
+    Diff[2] = Diff[1] + QNumPixels;
+    Diff[3] = Diff[2] + QNumPixels;
+    Result = Diff[3] + QNumPixels;
+    Temp = Result + QNumPixels;
+    Buffer = Temp + QNumPixels;
+
+    /* Extend the input to a GRBG mosaic with even dimensions */
+    for(i = 0; i < PadHeight; i++)
+        for(j = 0; j < PadWidth; j++)
+            Mosaic[j + PadWidth*i] = Input[SymwIndex(j + OffsetX, Width)
+                + Width*SymwIndex(i + OffsetY, Height)];
+
+    ExtractPhase(G00, Mosaic, 0, 0, QWidth, QHeight);
+    ExtractPhase(R01, Mosaic, 1, 0, QWidth, QHeight);
+    ExtractPhase(B10, Mosaic, 0, 1, QWidth, QHeight);
+    ExtractPhase(G11, Mosaic, 1, 1, QWidth, QHeight);
+
+    /* Estimate green at red and blue pixels and refine with the lowpass
+       subband of the observed channel */
+    for(i = 0; i < QHeight; i++)
+        for(j = 0; j < QWidth; j++)
+        {
+            Green01[j + QWidth*i] = EsiGreen(Mosaic, PadWidth, PadHeight,
+                2*j + 1, 2*i);
+            Green10[j + QWidth*i] = EsiGreen(Mosaic, PadWidth, PadHeight,
+                2*j, 2*i + 1);
+        }
+
+    RefineGreen(Green01, R01, Temp, Buffer, Boundary, QWidth, QHeight);
+    RefineGreen(Green10, B10, Temp, Buffer, Boundary, QWidth, QHeight);
+
+    /* Red: color differences interpolated from the nearest red pixels */
+    for(i = 0; i < QHeight; i++)
+    {
+        i1 = ClampIndex(i + 1, QHeight);
+
+        for(j = 0; j < QWidth; j++)
+        {
+            j0 = ClampIndex(j - 1, QWidth);
+            Diff[0][j + QWidth*i] = (R01[j + QWidth*i]
+                + R01[j0 + QWidth*i])/2 - G00[j + QWidth*i];
+            Diff[1][j + QWidth*i] = R01[j + QWidth*i]
+                - Green01[j + QWidth*i];
+            Diff[2][j + QWidth*i] = (R01[j + QWidth*i] + R01[j0 + QWidth*i]
+                + R01[j + QWidth*i1] + R01[j0 + QWidth*i1])/4
+                - Green10[j + QWidth*i];
+            Diff[3][j + QWidth*i] = (R01[j + QWidth*i]
+                + R01[j + QWidth*i1])/2 - G11[j + QWidth*i];
+        }
+    }
+
+    ApplyPolyphase(Result, Diff, Bank->Red[0], G00, Temp, Buffer,
+        Boundary, QWidth, QHeight);
+    ScatterPhase(Output, Width, Height, Result, QWidth, QHeight,
+        OffsetX, OffsetY);
+    ScatterPhase(Output, Width, Height, R01, QWidth, QHeight,
+        OffsetX + 1, OffsetY);
+    ApplyPolyphase(Result, Diff, Bank->Red[1], Green10, Temp, Buffer,
+        Boundary, QWidth, QHeight);
+    ScatterPhase(Output, Width, Height, Result, QWidth, QHeight,
+        OffsetX, OffsetY + 1);
+    ApplyPolyphase(Result, Diff, Bank->Red[2], G11, Temp, Buffer,
+        Boundary, QWidth, QHeight);
+    ScatterPhase(Output, Width, Height, Result, QWidth, QHeight,
+        OffsetX + 1, OffsetY + 1);
+
+    /* Green */
+    ScatterPhase(Output + NumPixels, Width, Height, G00, QWidth, QHeight,
+        OffsetX, OffsetY);
+    ScatterPhase(Output + NumPixels, Width, Height, Green01, QWidth, QHeight,
+        OffsetX + 1, OffsetY);
+    ScatterPhase(Output + NumPixels, Width, Height, Green10, QWidth, QHeight,
+        OffsetX, OffsetY + 1);
+    ScatterPhase(Output + NumPixels, Width, Height, G11, QWidth, QHeight,
+        OffsetX + 1, OffsetY + 1);
+
+    /* Blue: color differences interpolated from the nearest blue pixels */
+    for(i = 0; i < QHeight; i++)
+    {
+        i0 = ClampIndex(i - 1, QHeight);
+
+        for(j = 0; j < QWidth; j++)
+        {
+            j1 = ClampIndex(j + 1, QWidth);
+            Diff[0][j + QWidth*i] = (B10[j + QWidth*i]
+                + B10[j + QWidth*i0])/2 - G00[j + QWidth*i];
+            Diff[1][j + QWidth*i] = (B10[j + QWidth*i] + B10[j1 + QWidth*i]
+                + B10[j + QWidth*i0] + B10[j1 + QWidth*i0])/4
+                - Green01[j + QWidth*i];
+            Diff[2][j + QWidth*i] = B10[j + QWidth*i]
+                - Green10[j + QWidth*i];
+            Diff[3][j + QWidth*i] = (B10[j + QWidth*i]
+                + B10[j1 + QWidth*i])/2 - G11[j + QWidth*i];
+        }
+    }
+
+    ApplyPolyphase(Result, Diff, Bank->Blue[0], G00, Temp, Buffer,
+        Boundary, QWidth, QHeight);
+    ScatterPhase(Output + 2*NumPixels, Width, Height, Result,
+        QWidth, QHeight, OffsetX, OffsetY);
+    ApplyPolyphase(Result, Diff, Bank->Blue[1], Green01, Temp, Buffer,
+        Boundary, QWidth, QHeight);
+    ScatterPhase(Output + 2*NumPixels, Width, Height, Result,
+        QWidth, QHeight, OffsetX + 1, OffsetY);
+    ScatterPhase(Output + 2*NumPixels, Width, Height, B10,
+        QWidth, QHeight, OffsetX, OffsetY + 1);
+    ApplyPolyphase(Result, Diff, Bank->Blue[2], G11, Temp, Buffer,
+        Boundary, QWidth, QHeight);
+    ScatterPhase(Output + 2*NumPixels, Width, Height, Result,
+        QWidth, QHeight, OffsetX + 1, OffsetY + 1);
+
+    Success = 1;
+Catch:
+    Free(Mosaic);
+    return Success;
+}
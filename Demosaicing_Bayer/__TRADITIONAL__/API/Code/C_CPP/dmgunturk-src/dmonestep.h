@@ -0,0 +1,22 @@
+/**
+ * @file dmonestep.h
+ * @brief One-step polyphase implementation of Gunturk demosaicing
+ * @author Demosaicing_Bayer contributors
+ * 
+ * 
+ * Copyright (c) 2026, Demosaicing_Bayer contributors
+ * All rights reserved.
+ * 
+ * This program is free software: you can use, modify and/or 
+ * redistribute it under the terms of the simplified BSD License. You 
+ * should have received a copy of this license along this program. If 
+ * not, see <http://www.opensource.org/licenses/bsd-license.html>.
+ */
+
+#ifndef _DMONESTEP_H_
+#define _DMONESTEP_H_
+
+int OneStepDemosaic(float *Output, const float *Input, 
+    int Width, int Height, int RedX, int RedY, int NumIter);
+
+#endif /* _DMONESTEP_H_ */
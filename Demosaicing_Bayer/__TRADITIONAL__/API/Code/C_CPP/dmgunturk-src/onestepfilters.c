@@ -0,0 +1,1442 @@
+/**
+ * @file onestepfilters.c
+ * @brief Precomputed polyphase filters for one-step Gunturk demosaicing
+ * @author Demosaicing_Bayer contributors
+ * 
+ * The tables below are derived from the polyphase filters 
+ * poly_flts_niter_<n>.mat distributed with the MATLAB one-step code.  As 
+ * with simplify_filters(n, 6), each filter is truncated to its 6x6 central
+ * window and replaced by its best rank-1 (separable) approximation.  The
+ * windows capture more than 99% of the energy of every filter and the 
+ * rank-1 approximations more than 99.9% of the windows.  Filters with an
+ * L2 norm below 1e-3 (the cross-channel filters for 20 iterations) are
+ * stored as zero.
+ * 
+ * 
+ * Copyright (c) 2026, Demosaicing_Bayer contributors
+ * All rights reserved.
+ * 
+ * This program is free software: you can use, modify and/or 
+ * redistribute it under the terms of the simplified BSD License. You 
+ * should have received a copy of this license along this program. If 
+ * not, see <http://www.opensource.org/licenses/bsd-license.html>.
+ */
+
+#include <stdio.h>
+#include "onestepfilters.h"
+
+
+/** @brief Table of filter banks ordered by number of iterations */
+static const onestepfilterbank FilterBanks[] = {
+    /* 0 iterations */
+    {0,
+        { /* red */
+            {
+                {{0, 0, 0,
+                   1.0f, 0, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}}
+            },
+            {
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   1.0f, 0, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}}
+            },
+            {
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   1.0f, 0, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}}
+            }
+        },
+        { /* blue */
+            {
+                {{0, 0, 0,
+                   1.0f, 0, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}}
+            },
+            {
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   1.0f, 0, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}}
+            },
+            {
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   1.0f, 0, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}}
+            }
+        }
+    },
+    /* 1 iteration */
+    {1,
+        { /* red */
+            {
+                {{0, 0, 0,
+                   0.25f, 0, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}},
+                {{0, 0, 0,
+                   0.200097632f, 0, 0},
+                 {0, 0, -0.0780868809f,
+                   0.702781928f, 0.702781928f, -0.0780868809f}},
+                {{0, 0, -0.015625f,
+                   0.140625f, 0.140625f, -0.015625f},
+                 {0, 0, 0,
+                   1.0f, 0, 0}},
+                {{0, 0, -0.012506102f,
+                   0.112554918f, 0.112554918f, -0.012506102f},
+                 {0, 0, -0.0780868809f,
+                   0.702781928f, 0.702781928f, -0.0780868809f}}
+            },
+            {
+                {{0, -0.015625f, 0.140625f,
+                   0.140625f, -0.015625f, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}},
+                {{0, -0.012506102f, 0.112554918f,
+                   0.112554918f, -0.012506102f, 0},
+                 {0, 0, -0.0780868809f,
+                   0.702781928f, 0.702781928f, -0.0780868809f}},
+                {{0, 0, 0,
+                   0.25f, 0, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}},
+                {{0, 0, 0,
+                   0.200097632f, 0, 0},
+                 {0, 0, -0.0780868809f,
+                   0.702781928f, 0.702781928f, -0.0780868809f}}
+            },
+            {
+                {{0, -0.012506102f, 0.112554918f,
+                   0.112554918f, -0.012506102f, 0},
+                 {0, -0.0780868809f, 0.702781928f,
+                   0.702781928f, -0.0780868809f, 0}},
+                {{0, -0.015625f, 0.140625f,
+                   0.140625f, -0.015625f, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}},
+                {{0, 0, 0,
+                   0.200097632f, 0, 0},
+                 {0, -0.0780868809f, 0.702781928f,
+                   0.702781928f, -0.0780868809f, 0}},
+                {{0, 0, 0,
+                   0.25f, 0, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}}
+            }
+        },
+        { /* blue */
+            {
+                {{0, 0, 0,
+                   0.25f, 0, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}},
+                {{0, 0, 0,
+                   0.200097632f, 0, 0},
+                 {0, 0, -0.0780868809f,
+                   0.702781928f, 0.702781928f, -0.0780868809f}},
+                {{0, 0, -0.015625f,
+                   0.140625f, 0.140625f, -0.015625f},
+                 {0, 0, 0,
+                   1.0f, 0, 0}},
+                {{0, 0, -0.012506102f,
+                   0.112554918f, 0.112554918f, -0.012506102f},
+                 {0, 0, -0.0780868809f,
+                   0.702781928f, 0.702781928f, -0.0780868809f}}
+            },
+            {
+                {{0, 0, 0,
+                   0.200097632f, 0, 0},
+                 {0, -0.0780868809f, 0.702781928f,
+                   0.702781928f, -0.0780868809f, 0}},
+                {{0, 0, 0,
+                   0.25f, 0, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}},
+                {{0, 0, -0.012506102f,
+                   0.112554918f, 0.112554918f, -0.012506102f},
+                 {0, -0.0780868809f, 0.702781928f,
+                   0.702781928f, -0.0780868809f, 0}},
+                {{0, 0, -0.015625f,
+                   0.140625f, 0.140625f, -0.015625f},
+                 {0, 0, 0,
+                   1.0f, 0, 0}}
+            },
+            {
+                {{0, -0.012506102f, 0.112554918f,
+                   0.112554918f, -0.012506102f, 0},
+                 {0, -0.0780868809f, 0.702781928f,
+                   0.702781928f, -0.0780868809f, 0}},
+                {{0, -0.015625f, 0.140625f,
+                   0.140625f, -0.015625f, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}},
+                {{0, 0, 0,
+                   0.200097632f, 0, 0},
+                 {0, -0.0780868809f, 0.702781928f,
+                   0.702781928f, -0.0780868809f, 0}},
+                {{0, 0, 0,
+                   0.25f, 0, 0},
+                 {0, 0, 0,
+                   1.0f, 0, 0}}
+            }
+        }
+    },
+    /* 2 iterations */
+    {2,
+        { /* red */
+            {
+                {{0.000408277316f, -0.00734899168f, 0.0257214709f,
+                   0.129001346f, 0.0257214709f, -0.00734899168f},
+                 {0.00130138755f, -0.023424976f, 0.0819874159f,
+                   0.992701856f, 0.0819874159f, -0.023424976f}},
+                {{0.000390815688f, -0.00703468239f, 0.0246213884f,
+                   0.314215813f, 0.0246213884f, -0.00703468239f},
+                 {0, 0, -0.0780868809f,
+                   0.702781928f, 0.702781928f, -0.0780868809f}},
+                {{0, 0, -0.010411404f,
+                   0.0937026359f, 0.0937026359f, -0.010411404f},
+                 {0.00146558419f, -0.0263805154f, 0.0923318039f,
+                   0.990734911f, 0.0923318039f, -0.0263805154f}},
+                {{0, 0, -0.00937957652f,
+                   0.0844161887f, 0.0844161887f, -0.00937957652f},
+                 {0, 0, -0.0780868809f,
+                   0.702781928f, 0.702781928f, -0.0780868809f}}
+            },
+            {
+                {{0, -0.010411404f, 0.0937026359f,
+                   0.0937026359f, -0.010411404f, 0},
+                 {0.00146558419f, -0.0263805154f, 0.0923318039f,
+                   0.990734911f, 0.0923318039f, -0.0263805154f}},
+                {{0, -0.0218856785f, 0.196971107f,
+                   0.196971107f, -0.0218856785f, 0},
+                 {0, 0, -0.0780868809f,
+                   0.702781928f, 0.702781928f, -0.0780868809f}},
+                {{0.000241264474f, -0.00434276053f, 0.0151996619f,
+                   0.144360865f, 0.0151996619f, -0.00434276053f},
+                 {0.00165157092f, -0.0297282765f, 0.104048968f,
+                   0.988219285f, 0.104048968f, -0.0297282765f}},
+                {{0.000195407844f, -0.00351734119f, 0.0123106942f,
+                   0.132095703f, 0.0123106942f, -0.00351734119f},
+                 {0, 0, -0.0780868809f,
+                   0.702781928f, 0.702781928f, -0.0780868809f}}
+            },
+            {
+                {{0, -0.00937957652f, 0.0844161887f,
+                   0.0844161887f, -0.00937957652f, 0},
+                 {0, -0.0780868809f, 0.702781928f,
+                   0.702781928f, -0.0780868809f, 0}},
+                {{0, -0.0246985643f, 0.222287079f,
+                   0.222287079f, -0.0246985643f, 0},
+                 {0.0012356013f, -0.0222408233f, 0.0778428817f,
+                   0.993423443f, 0.0778428817f, -0.0222408233f}},
+                {{0.000195407844f, -0.00351734119f, 0.0123106942f,
+                   0.132095703f, 0.0123106942f, -0.00351734119f},
+                 {0, -0.0780868809f, 0.702781928f,
+                   0.702781928f, -0.0780868809f, 0}},
+                {{0.000174951785f, -0.00314913213f, 0.0110219624f,
+                   0.133453683f, 0.0110219624f, -0.00314913213f},
+                 {0.00303699112f, -0.0546658402f, 0.191330441f,
+                   0.959582927f, 0.191330441f, -0.0546658402f}}
+            }
+        },
+        { /* blue */
+            {
+                {{0.000174951785f, -0.00314913213f, 0.0110219624f,
+                   0.133453683f, 0.0110219624f, -0.00314913213f},
+                 {0.00303699112f, -0.0546658402f, 0.191330441f,
+                   0.959582927f, 0.191330441f, -0.0546658402f}},
+                {{0.000195407844f, -0.00351734119f, 0.0123106942f,
+                   0.132095703f, 0.0123106942f, -0.00351734119f},
+                 {0, 0, -0.0780868809f,
+                   0.702781928f, 0.702781928f, -0.0780868809f}},
+                {{0, 0, -0.0246985643f,
+                   0.222287079f, 0.222287079f, -0.0246985643f},
+                 {0.0012356013f, -0.0222408233f, 0.0778428817f,
+                   0.993423443f, 0.0778428817f, -0.0222408233f}},
+                {{0, 0, -0.00937957652f,
+                   0.0844161887f, 0.0844161887f, -0.00937957652f},
+                 {0, 0, -0.0780868809f,
+                   0.702781928f, 0.702781928f, -0.0780868809f}}
+            },
+            {
+                {{0.000195407844f, -0.00351734119f, 0.0123106942f,
+                   0.132095703f, 0.0123106942f, -0.00351734119f},
+                 {0, -0.0780868809f, 0.702781928f,
+                   0.702781928f, -0.0780868809f, 0}},
+                {{0.000241264474f, -0.00434276053f, 0.0151996619f,
+                   0.144360865f, 0.0151996619f, -0.00434276053f},
+                 {0.00165157092f, -0.0297282765f, 0.104048968f,
+                   0.988219285f, 0.104048968f, -0.0297282765f}},
+                {{0, 0, -0.0218856785f,
+                   0.196971107f, 0.196971107f, -0.0218856785f},
+                 {0, -0.0780868809f, 0.702781928f,
+                   0.702781928f, -0.0780868809f, 0}},
+                {{0, 0, -0.010411404f,
+                   0.0937026359f, 0.0937026359f, -0.010411404f},
+                 {0.00146558419f, -0.0263805154f, 0.0923318039f,
+                   0.990734911f, 0.0923318039f, -0.0263805154f}}
+            },
+            {
+                {{0, -0.00937957652f, 0.0844161887f,
+                   0.0844161887f, -0.00937957652f, 0},
+                 {0, -0.0780868809f, 0.702781928f,
+                   0.702781928f, -0.0780868809f, 0}},
+                {{0, -0.010411404f, 0.0937026359f,
+                   0.0937026359f, -0.010411404f, 0},
+                 {0.00146558419f, -0.0263805154f, 0.0923318039f,
+                   0.990734911f, 0.0923318039f, -0.0263805154f}},
+                {{0.000390815688f, -0.00703468239f, 0.0246213884f,
+                   0.314215813f, 0.0246213884f, -0.00703468239f},
+                 {0, -0.0780868809f, 0.702781928f,
+                   0.702781928f, -0.0780868809f, 0}},
+                {{0.000408277316f, -0.00734899168f, 0.0257214709f,
+                   0.129001346f, 0.0257214709f, -0.00734899168f},
+                 {0.00130138755f, -0.023424976f, 0.0819874159f,
+                   0.992701856f, 0.0819874159f, -0.023424976f}}
+            }
+        }
+    },
+    /* 3 iterations */
+    {3,
+        { /* red */
+            {
+                {{0.000393989205f, -0.00709180569f, 0.0248213199f,
+                   0.0797968567f, 0.0248213199f, -0.00709180569f},
+                 {0.00254966221f, -0.0458939198f, 0.160628719f,
+                   0.971688131f, 0.160628719f, -0.0458939198f}},
+                {{0.000766660148f, -0.0137998827f, 0.0482995893f,
+                   0.388349286f, 0.0482995893f, -0.0137998827f},
+                 {0.000362792827f, -0.00290234261f, -0.0719514907f,
+                   0.703433512f, 0.703433512f, -0.0719514907f}},
+                {{0.000172965344f, -0.00138372275f, -0.00407551252f,
+                   0.0633162757f, 0.0633162757f, -0.00407551252f},
+                 {0.00264001973f, -0.0475203551f, 0.166321243f,
+                   0.969613918f, 0.166321243f, -0.0475203551f}},
+                {{0.000152743045f, -0.00122194436f, -0.00399454194f,
+                   0.0594733064f, 0.0594733064f, -0.00399454194f},
+                 {0.00181175989f, -0.0144940791f, -0.0473812138f,
+                   0.705441947f, 0.705441947f, -0.0473812138f}}
+            },
+            {
+                {{-0.00138372305f, -0.0040755119f, 0.0633162757f,
+                   0.0633162757f, -0.0040755119f, -0.00138372305f},
+                 {0.00263994627f, -0.0475190329f, 0.166316615f,
+                   0.969615636f, 0.166316615f, -0.0475190329f}},
+                {{-0.001318916f, -0.0256515726f, 0.256253286f,
+                   0.256253286f, -0.0256515726f, -0.001318916f},
+                 {0.000452656869f, -0.00362125495f, -0.0704307282f,
+                   0.703585711f, 0.703585711f, -0.0704307282f}},
+                {{0.000263873225f, -0.00474971805f, 0.0166240132f,
+                   0.0917591168f, 0.0166240132f, -0.00474971805f},
+                 {0.00277874611f, -0.05001743f, 0.175061005f,
+                   0.966279505f, 0.175061005f, -0.05001743f}},
+                {{0.000236912401f, -0.00426442322f, 0.0149254813f,
+                   0.0870120625f, 0.0149254813f, -0.00426442322f},
+                 {0.00192742937f, -0.015419435f, -0.0454152395f,
+                   0.705561279f, 0.705561279f, -0.0454152395f}}
+            },
+            {
+                {{-0.00122243916f, -0.00399417226f, 0.0594795042f,
+                   0.0594795042f, -0.00399417226f, -0.00122243916f},
+                 {-0.0144969494f, -0.0473670305f, 0.705369551f,
+                   0.705369551f, -0.0473670305f, -0.0144969494f}},
+                {{-0.00114582869f, -0.0284060169f, 0.277711354f,
+                   0.277711354f, -0.0284060169f, -0.00114582869f},
+                 {0.00194195483f, -0.0349551869f, 0.122343154f,
+                   0.983675152f, 0.122343154f, -0.0349551869f}},
+                {{0.000236933531f, -0.00426480355f, 0.0149268124f,
+                   0.0870223984f, 0.0149268124f, -0.00426480355f},
+                 {-0.0154176341f, -0.045409919f, 0.705478728f,
+                   0.705478728f, -0.045409919f, -0.0154176341f}},
+                {{0.000223738878f, -0.00402729981f, 0.0140955493f,
+                   0.0852679275f, 0.0140955493f, -0.00402729981f},
+                 {0.00448978468f, -0.0808161242f, 0.282856435f,
+                   0.909341424f, 0.282856435f, -0.0808161242f}}
+            }
+        },
+        { /* blue */
+            {
+                {{0.000223738878f, -0.00402729981f, 0.0140955493f,
+                   0.0852679275f, 0.0140955493f, -0.00402729981f},
+                 {0.00448978468f, -0.0808161242f, 0.282856435f,
+                   0.909341424f, 0.282856435f, -0.0808161242f}},
+                {{0.000236912401f, -0.00426442322f, 0.0149254813f,
+                   0.0870120625f, 0.0149254813f, -0.00426442322f},
+                 {0.00192742937f, -0.015419435f, -0.0454152395f,
+                   0.705561279f, 0.705561279f, -0.0454152395f}},
+                {{0.000143228444f, -0.00114582755f, -0.0284060193f,
+                   0.277711354f, 0.277711354f, -0.0284060193f},
+                 {0.00194192435f, -0.0349546382f, 0.122341234f,
+                   0.983675668f, 0.122341234f, -0.0349546382f}},
+                {{0.000152743045f, -0.00122194436f, -0.00399454194f,
+                   0.0594733064f, 0.0594733064f, -0.00399454194f},
+                 {0.00181175989f, -0.0144940791f, -0.0473812138f,
+                   0.705441947f, 0.705441947f, -0.0473812138f}}
+            },
+            {
+                {{0.000236933531f, -0.00426480355f, 0.0149268124f,
+                   0.0870223984f, 0.0149268124f, -0.00426480355f},
+                 {-0.0154176341f, -0.045409919f, 0.705478728f,
+                   0.705478728f, -0.045409919f, -0.0154176341f}},
+                {{0.000263873225f, -0.00474971805f, 0.0166240132f,
+                   0.0917591168f, 0.0166240132f, -0.00474971805f},
+                 {0.00277874611f, -0.05001743f, 0.175061005f,
+                   0.966279505f, 0.175061005f, -0.05001743f}},
+                {{0.000164863435f, -0.00131890748f, -0.0256517742f,
+                   0.256254937f, 0.256254937f, -0.0256517742f},
+                 {-0.00362127833f, -0.0704301747f, 0.70358118f,
+                   0.70358118f, -0.0704301747f, -0.00362127833f}},
+                {{0.000172965344f, -0.00138372275f, -0.00407551252f,
+                   0.0633162757f, 0.0633162757f, -0.00407551252f},
+                 {0.00264001973f, -0.0475203551f, 0.166321243f,
+                   0.969613918f, 0.166321243f, -0.0475203551f}}
+            },
+            {
+                {{-0.00122243916f, -0.00399417226f, 0.0594795042f,
+                   0.0594795042f, -0.00399417226f, -0.00122243916f},
+                 {-0.0144969494f, -0.0473670305f, 0.705369551f,
+                   0.705369551f, -0.0473670305f, -0.0144969494f}},
+                {{-0.00138372305f, -0.0040755119f, 0.0633162757f,
+                   0.0633162757f, -0.0040755119f, -0.00138372305f},
+                 {0.00263994627f, -0.0475190329f, 0.166316615f,
+                   0.969615636f, 0.166316615f, -0.0475190329f}},
+                {{0.000766675361f, -0.0138001565f, 0.0483005477f,
+                   0.388350692f, 0.0483005477f, -0.0138001565f},
+                 {-0.00290233347f, -0.0719511863f, 0.703430596f,
+                   0.703430596f, -0.0719511863f, -0.00290233347f}},
+                {{0.000393989205f, -0.00709180569f, 0.0248213199f,
+                   0.0797968567f, 0.0248213199f, -0.00709180569f},
+                 {0.00254966221f, -0.0458939198f, 0.160628719f,
+                   0.971688131f, 0.160628719f, -0.0458939198f}}
+            }
+        }
+    },
+    /* 4 iterations */
+    {4,
+        { /* red */
+            {
+                {{-8.87102423e-05f, -0.00504171967f, 0.0198200842f,
+                   0.0530647269f, 0.0198200842f, -0.00504171967f},
+                 {0.000443608459f, -0.0586794613f, 0.221980225f,
+                   0.945813303f, 0.221980225f, -0.0586794613f}},
+                {{0.000674742741f, -0.0186251961f, 0.0673102859f,
+                   0.438749052f, 0.0673102859f, -0.0186251961f},
+                 {0.000796374084f, -0.00637099267f, -0.0646102822f,
+                   0.704134149f, 0.704134149f, -0.0646102822f}},
+                {{0.000244256619f, -0.00195405295f, -0.000675073067f,
+                   0.0436911769f, 0.0436911769f, -0.000675073067f},
+                 {0.000377569909f, -0.0594199523f, 0.225203738f,
+                   0.944195397f, 0.225203738f, -0.0594199523f}},
+                {{0.000226841202f, -0.00181472962f, -0.000770167111f,
+                   0.0418650491f, 0.0418650491f, -0.000770167111f},
+                 {0.00382890715f, -0.0306312572f, -0.0129998357f,
+                   0.706650223f, 0.706650223f, -0.0129998357f}}
+            },
+            {
+                {{-0.0019540539f, -0.000675071046f, 0.0436911769f,
+                   0.0436911769f, -0.000675071046f, -0.0019540539f},
+                 {0.000376965165f, -0.0594154098f, 0.225189917f,
+                   0.944202562f, 0.225189917f, -0.0594154098f}},
+                {{-0.00319778752f, -0.0262581596f, 0.297880846f,
+                   0.297880846f, -0.0262581596f, -0.00319778752f},
+                 {0.000945209553f, -0.00756167643f, -0.0620880863f,
+                   0.704355048f, 0.704355048f, -0.0620880863f}},
+                {{1.39271671e-05f, -0.00389917237f, 0.014841957f,
+                   0.0605949205f, 0.014841957f, -0.00389917237f},
+                 {0.00021638146f, -0.0605800592f, 0.230594226f,
+                   0.941441805f, 0.230594226f, -0.0605800592f}},
+                {{2.33441655e-05f, -0.00367378112f, 0.0139237615f,
+                   0.0583771459f, 0.0139237615f, -0.00367378112f},
+                 {0.00395062095f, -0.0316049676f, -0.0109186716f,
+                   0.70666367f, 0.70666367f, -0.0109186716f}}
+            },
+            {
+                {{-0.00181618628f, -0.000769200322f, 0.0418843889f,
+                   0.0418843889f, -0.000769200322f, -0.00181618628f},
+                 {-0.030627547f, -0.0129715323f, 0.706324071f,
+                   0.706324071f, -0.0129715323f, -0.030627547f}},
+                {{-0.00286523249f, -0.0290571052f, 0.316669672f,
+                   0.316669672f, -0.0290571052f, -0.00286523249f},
+                 {0.00150030323f, -0.0414163886f, 0.149676843f,
+                   0.975582288f, 0.149676843f, -0.0414163886f}},
+                {{2.33182314e-05f, -0.00367530584f, 0.0139297502f,
+                   0.0584062822f, 0.0139297502f, -0.00367530584f},
+                 {-0.0315894562f, -0.0109132749f, 0.706316506f,
+                   0.706316506f, -0.0109132749f, -0.0315894562f}},
+                {{2.68094524e-05f, -0.00354628996f, 0.0134153625f,
+                   0.0571601741f, 0.0134153625f, -0.00354628996f},
+                 {-0.0014678634f, -0.0834239156f, 0.327957352f,
+                   0.878047093f, 0.327957352f, -0.0834239156f}}
+            }
+        },
+        { /* blue */
+            {
+                {{2.68094524e-05f, -0.00354628996f, 0.0134153625f,
+                   0.0571601741f, 0.0134153625f, -0.00354628996f},
+                 {-0.0014678634f, -0.0834239156f, 0.327957352f,
+                   0.878047093f, 0.327957352f, -0.0834239156f}},
+                {{2.33441655e-05f, -0.00367378112f, 0.0139237615f,
+                   0.0583771459f, 0.0139237615f, -0.00367378112f},
+                 {0.00395062095f, -0.0316049676f, -0.0109186716f,
+                   0.70666367f, 0.70666367f, -0.0109186716f}},
+                {{0.00035815266f, -0.00286522128f, -0.0290571289f,
+                   0.31666967f, 0.31666967f, -0.0290571289f},
+                 {0.00150033126f, -0.0414142491f, 0.149668489f,
+                   0.975585033f, 0.149668489f, -0.0414142491f}},
+                {{0.000226841202f, -0.00181472962f, -0.000770167111f,
+                   0.0418650491f, 0.0418650491f, -0.000770167111f},
+                 {0.00382890715f, -0.0306312572f, -0.0129998357f,
+                   0.706650223f, 0.706650223f, -0.0129998357f}}
+            },
+            {
+                {{2.33182314e-05f, -0.00367530584f, 0.0139297502f,
+                   0.0584062822f, 0.0139297502f, -0.00367530584f},
+                 {-0.0315894562f, -0.0109132749f, 0.706316506f,
+                   0.706316506f, -0.0109132749f, -0.0315894562f}},
+                {{1.39271671e-05f, -0.00389917237f, 0.014841957f,
+                   0.0605949205f, 0.014841957f, -0.00389917237f},
+                 {0.00021638146f, -0.0605800592f, 0.230594226f,
+                   0.941441805f, 0.230594226f, -0.0605800592f}},
+                {{0.00039975261f, -0.00319802088f, -0.0262585947f,
+                   0.297889254f, 0.297889254f, -0.0262585947f},
+                 {-0.00756112464f, -0.0620870575f, 0.704335166f,
+                   0.704335166f, -0.0620870575f, -0.00756112464f}},
+                {{0.000244256619f, -0.00195405295f, -0.000675073067f,
+                   0.0436911769f, 0.0436911769f, -0.000675073067f},
+                 {0.000377569909f, -0.0594199523f, 0.225203738f,
+                   0.944195397f, 0.225203738f, -0.0594199523f}}
+            },
+            {
+                {{-0.00181618628f, -0.000769200322f, 0.0418843889f,
+                   0.0418843889f, -0.000769200322f, -0.00181618628f},
+                 {-0.030627547f, -0.0129715323f, 0.706324071f,
+                   0.706324071f, -0.0129715323f, -0.030627547f}},
+                {{-0.0019540539f, -0.000675071046f, 0.0436911769f,
+                   0.0436911769f, -0.000675071046f, -0.0019540539f},
+                 {0.000376965165f, -0.0594154098f, 0.225189917f,
+                   0.944202562f, 0.225189917f, -0.0594154098f}},
+                {{0.000674743612f, -0.0186265304f, 0.0673153878f,
+                   0.438756583f, 0.0673153878f, -0.0186265304f},
+                 {-0.00637089031f, -0.0646089387f, 0.704120087f,
+                   0.704120087f, -0.0646089387f, -0.00637089031f}},
+                {{-8.87102423e-05f, -0.00504171967f, 0.0198200842f,
+                   0.0530647269f, 0.0198200842f, -0.00504171967f},
+                 {0.000443608459f, -0.0586794613f, 0.221980225f,
+                   0.945813303f, 0.221980225f, -0.0586794613f}}
+            }
+        }
+    },
+    /* 5 iterations */
+    {5,
+        { /* red */
+            {
+                {{-0.000448582263f, -0.00326072077f, 0.0151247248f,
+                   0.0364714044f, 0.0151247248f, -0.00326072077f},
+                 {-0.00443730742f, -0.063702849f, 0.269979614f,
+                   0.919829452f, 0.269979614f, -0.063702849f}},
+                {{0.000236314599f, -0.021758609f, 0.0818878833f,
+                   0.473714588f, 0.0818878833f, -0.021758609f},
+                 {0.00109155822f, -0.00946854676f, -0.0577698592f,
+                   0.704710736f, 0.704710736f, -0.0577698592f}},
+                {{0.000191415116f, -0.00194133301f, 0.000905835801f,
+                   0.0306176394f, 0.0306176394f, 0.000905835801f},
+                 {-0.00460094659f, -0.0639797821f, 0.272004207f,
+                   0.918596445f, 0.272004207f, -0.0639797821f}},
+                {{0.000183813474f, -0.0018509501f, 0.000807242362f,
+                   0.0296641782f, 0.0296641782f, 0.000807242362f},
+                 {0.00437565555f, -0.0440616235f, 0.0192162982f,
+                   0.706151859f, 0.706151859f, 0.0192162982f}}
+            },
+            {
+                {{-0.00194133389f, 0.000905837821f, 0.0306176393f,
+                   0.0306176393f, 0.000905837821f, -0.00194133389f},
+                 {-0.00460139062f, -0.0639742293f, 0.271985571f,
+                   0.918608252f, 0.271985571f, -0.0639742293f}},
+                {{-0.0050736519f, -0.0253611861f, 0.327285205f,
+                   0.327285205f, -0.0253611861f, -0.0050736519f},
+                 {0.00125838704f, -0.0109297849f, -0.0546231031f,
+                   0.704950917f, 0.704950917f, -0.0546231031f}},
+                {{-0.000219519521f, -0.00287727067f, 0.012306775f,
+                   0.0409830496f, 0.012306775f, -0.00287727067f},
+                 {-0.0049096745f, -0.0643517367f, 0.275247774f,
+                   0.916608384f, 0.275247774f, -0.0643517367f}},
+                {{-0.000199509595f, -0.00277433789f, 0.0117948444f,
+                   0.0398328477f, 0.0117948444f, -0.00277433789f},
+                 {0.00441427753f, -0.0447696238f, 0.0208897328f,
+                   0.706081947f, 0.706081947f, 0.0208897328f}}
+            },
+            {
+                {{-0.00185316564f, 0.000809031619f, 0.0296926346f,
+                   0.0296926346f, 0.000809031619f, -0.00185316564f},
+                 {-0.0440297068f, 0.0192219325f, 0.705472822f,
+                   0.705472822f, 0.0192219325f, -0.0440297068f}},
+                {{-0.0046266946f, -0.0282282701f, 0.344345996f,
+                   0.344345996f, -0.0282282701f, -0.0046266946f},
+                 {0.00048322277f, -0.0445333711f, 0.167602638f,
+                   0.969459662f, 0.167602638f, -0.0445333711f}},
+                {{-0.000199726767f, -0.0027768488f, 0.0118057351f,
+                   0.0398728714f, 0.0118057351f, -0.0027768488f},
+                 {-0.0447252798f, 0.0208690788f, 0.705382259f,
+                   0.705382259f, 0.0208690788f, -0.0447252798f}},
+                {{-0.00018873657f, -0.00270953893f, 0.0114833212f,
+                   0.0391240541f, 0.0114833212f, -0.00270953893f},
+                 {-0.010546432f, -0.0766614571f, 0.355591148f,
+                   0.857464102f, 0.355591148f, -0.0766614571f}}
+            }
+        },
+        { /* blue */
+            {
+                {{-0.00018873657f, -0.00270953893f, 0.0114833212f,
+                   0.0391240541f, 0.0114833212f, -0.00270953893f},
+                 {-0.010546432f, -0.0766614571f, 0.355591148f,
+                   0.857464102f, 0.355591148f, -0.0766614571f}},
+                {{-0.000199509595f, -0.00277433789f, 0.0117948444f,
+                   0.0398328477f, 0.0117948444f, -0.00277433789f},
+                 {0.00441427753f, -0.0447696238f, 0.0208897328f,
+                   0.706081947f, 0.706081947f, 0.0208897328f}},
+                {{0.000533373024f, -0.00462665877f, -0.0282283473f,
+                   0.34434599f, 0.34434599f, -0.0282283473f},
+                 {0.000483622403f, -0.0445294145f, 0.167585139f,
+                   0.969466075f, 0.167585139f, -0.0445294145f}},
+                {{0.000183813474f, -0.0018509501f, 0.000807242362f,
+                   0.0296641782f, 0.0296641782f, 0.000807242362f},
+                 {0.00437565555f, -0.0440616235f, 0.0192162982f,
+                   0.706151859f, 0.706151859f, 0.0192162982f}}
+            },
+            {
+                {{-0.000199726767f, -0.0027768488f, 0.0118057351f,
+                   0.0398728714f, 0.0118057351f, -0.0027768488f},
+                 {-0.0447252798f, 0.0208690788f, 0.705382259f,
+                   0.705382259f, 0.0208690788f, -0.0447252798f}},
+                {{-0.000219519521f, -0.00287727067f, 0.012306775f,
+                   0.0409830496f, 0.012306775f, -0.00287727067f},
+                 {-0.0049096745f, -0.0643517367f, 0.275247774f,
+                   0.916608384f, 0.275247774f, -0.0643517367f}},
+                {{0.000584261765f, -0.0050746354f, -0.0253611882f,
+                   0.3273046f, 0.3273046f, -0.0253611882f},
+                 {-0.0109276666f, -0.0546230986f, 0.704909145f,
+                   0.704909145f, -0.0546230986f, -0.0109276666f}},
+                {{0.000191415116f, -0.00194133301f, 0.000905835801f,
+                   0.0306176394f, 0.0306176394f, 0.000905835801f},
+                 {-0.00460094659f, -0.0639797821f, 0.272004207f,
+                   0.918596445f, 0.272004207f, -0.0639797821f}}
+            },
+            {
+                {{-0.00185316564f, 0.000809031619f, 0.0296926346f,
+                   0.0296926346f, 0.000809031619f, -0.00185316564f},
+                 {-0.0440297068f, 0.0192219325f, 0.705472822f,
+                   0.705472822f, 0.0192219325f, -0.0440297068f}},
+                {{-0.00194133389f, 0.000905837821f, 0.0306176393f,
+                   0.0306176393f, 0.000905837821f, -0.00194133389f},
+                 {-0.00460139062f, -0.0639742293f, 0.271985571f,
+                   0.918608252f, 0.271985571f, -0.0639742293f}},
+                {{0.000236129769f, -0.0217615048f, 0.0819000566f,
+                   0.473732406f, 0.0819000566f, -0.0217615048f},
+                 {-0.00946820129f, -0.0577671463f, 0.70467958f,
+                   0.70467958f, -0.0577671463f, -0.00946820129f}},
+                {{-0.000448582263f, -0.00326072077f, 0.0151247248f,
+                   0.0364714044f, 0.0151247248f, -0.00326072077f},
+                 {-0.00443730742f, -0.063702849f, 0.269979614f,
+                   0.919829452f, 0.269979614f, -0.063702849f}}
+            }
+        }
+    },
+    /* 6 iterations */
+    {6,
+        { /* red */
+            {
+                {{-0.00060555389f, -0.00201758207f, 0.0113863391f,
+                   0.0255116407f, 0.0113863391f, -0.00201758207f},
+                 {-0.0109092886f, -0.0632580585f, 0.307905829f,
+                   0.89569293f, 0.307905829f, -0.0632580585f}},
+                {{-0.000352238785f, -0.0237023518f, 0.0928892341f,
+                   0.498248135f, 0.0928892341f, -0.0237023518f},
+                 {0.0012141556f, -0.0119608505f, -0.0519143422f,
+                   0.705147242f, 0.705147242f, -0.0519143422f}},
+                {{9.85777992e-05f, -0.00168049514f, 0.00152236784f,
+                   0.0216924649f, 0.0216924649f, 0.00152236784f},
+                 {-0.0111110982f, -0.0632888299f, 0.309253301f,
+                   0.894757164f, 0.309253301f, -0.0632888299f}},
+                {{9.72250752e-05f, -0.0016253344f, 0.00144691687f,
+                   0.0211583365f, 0.0211583365f, 0.00144691687f},
+                 {0.00323690233f, -0.0541120557f, 0.0481720232f,
+                   0.704421862f, 0.704421862f, 0.0481720232f}}
+            },
+            {
+                {{-0.00168049562f, 0.00152236908f, 0.0216924648f,
+                   0.0216924648f, 0.00152236908f, -0.00168049562f},
+                 {-0.0111106235f, -0.0632848538f, 0.309235346f,
+                   0.894770144f, 0.309235346f, -0.0632848538f}},
+                {{-0.00670051225f, -0.0238731473f, 0.348178288f,
+                   0.348178288f, -0.0238731473f, -0.00670051225f},
+                 {0.00137546672f, -0.0135778494f, -0.0483583747f,
+                   0.705385244f, 0.705385244f, -0.0483583747f}},
+                {{-0.000361106895f, -0.00199754816f, 0.00982438885f,
+                   0.0281986463f, 0.00982438885f, -0.00199754816f},
+                 {-0.0114403199f, -0.0632848344f, 0.311248976f,
+                   0.893368529f, 0.311248976f, -0.0632848344f}},
+                {{-0.000342213718f, -0.00194924979f, 0.00952477605f,
+                   0.0275578678f, 0.00952477605f, -0.00194924979f},
+                 {0.00320065371f, -0.054562823f, 0.049428698f,
+                   0.704317493f, 0.704317493f, 0.049428698f}}
+            },
+            {
+                {{-0.00162791024f, 0.00144957543f, 0.0211891347f,
+                   0.0211891347f, 0.00144957543f, -0.00162791024f},
+                 {-0.0540401233f, 0.0481201193f, 0.703394711f,
+                   0.703394711f, 0.0481201193f, -0.0540401233f}},
+                {{-0.00617622437f, -0.026806537f, 0.364112641f,
+                   0.364112641f, -0.026806537f, -0.00617622437f},
+                 {-0.000683241016f, -0.0459078186f, 0.179918212f,
+                   0.964905877f, 0.179918212f, -0.0459078186f}},
+                {{-0.000342706349f, -0.00195201658f, 0.0095383411f,
+                   0.0275991181f, 0.0095383411f, -0.00195201658f},
+                 {-0.054482078f, 0.0493555771f, 0.703275003f,
+                   0.703275003f, 0.0493555771f, -0.054482078f}},
+                {{-0.000330652101f, -0.00191730283f, 0.00933238757f,
+                   0.02714776f, 0.00933238757f, -0.00191730283f},
+                 {-0.019979193f, -0.0665665967f, 0.375672374f,
+                   0.841712031f, 0.375672374f, -0.0665665967f}}
+            }
+        },
+        { /* blue */
+            {
+                {{-0.000330652101f, -0.00191730283f, 0.00933238757f,
+                   0.02714776f, 0.00933238757f, -0.00191730283f},
+                 {-0.019979193f, -0.0665665967f, 0.375672374f,
+                   0.841712031f, 0.375672374f, -0.0665665967f}},
+                {{-0.000342213718f, -0.00194924979f, 0.00952477605f,
+                   0.0275578678f, 0.00952477605f, -0.00194924979f},
+                 {0.00320065371f, -0.054562823f, 0.049428698f,
+                   0.704317493f, 0.704317493f, 0.049428698f}},
+                {{0.000626946206f, -0.00617615227f, -0.0268066959f,
+                   0.36411263f, 0.36411263f, -0.0268066959f},
+                 {-0.000682152135f, -0.0459024122f, 0.179891006f,
+                   0.964916537f, 0.179891006f, -0.0459024122f}},
+                {{9.72250752e-05f, -0.0016253344f, 0.00144691687f,
+                   0.0211583365f, 0.0211583365f, 0.00144691687f},
+                 {0.00323690233f, -0.0541120557f, 0.0481720232f,
+                   0.704421862f, 0.704421862f, 0.0481720232f}}
+            },
+            {
+                {{-0.000342706349f, -0.00195201658f, 0.0095383411f,
+                   0.0275991181f, 0.0095383411f, -0.00195201658f},
+                 {-0.054482078f, 0.0493555771f, 0.703275003f,
+                   0.703275003f, 0.0493555771f, -0.054482078f}},
+                {{-0.000361106895f, -0.00199754816f, 0.00982438885f,
+                   0.0281986463f, 0.00982438885f, -0.00199754816f},
+                 {-0.0114403199f, -0.0632848344f, 0.311248976f,
+                   0.893368529f, 0.311248976f, -0.0632848344f}},
+                {{0.000678992968f, -0.00670264436f, -0.0238718945f,
+                   0.348210258f, 0.348210258f, -0.0238718945f},
+                 {-0.0135735303f, -0.0483609126f, 0.705320481f,
+                   0.705320481f, -0.0483609126f, -0.0135735303f}},
+                {{9.85777992e-05f, -0.00168049514f, 0.00152236784f,
+                   0.0216924649f, 0.0216924649f, 0.00152236784f},
+                 {-0.0111110982f, -0.0632888299f, 0.309253301f,
+                   0.894757164f, 0.309253301f, -0.0632888299f}}
+            },
+            {
+                {{-0.00162791024f, 0.00144957543f, 0.0211891347f,
+                   0.0211891347f, 0.00144957543f, -0.00162791024f},
+                 {-0.0540401233f, 0.0481201193f, 0.703394711f,
+                   0.703394711f, 0.0481201193f, -0.0540401233f}},
+                {{-0.00168049562f, 0.00152236908f, 0.0216924648f,
+                   0.0216924648f, 0.00152236908f, -0.00168049562f},
+                 {-0.0111106235f, -0.0632848538f, 0.309235346f,
+                   0.894770144f, 0.309235346f, -0.0632848538f}},
+                {{-0.00035282602f, -0.0237068217f, 0.0929098591f,
+                   0.498277902f, 0.0929098591f, -0.0237068217f},
+                 {-0.0119601435f, -0.0519103597f, 0.705097348f,
+                   0.705097348f, -0.0519103597f, -0.0119601435f}},
+                {{-0.00060555389f, -0.00201758207f, 0.0113863391f,
+                   0.0255116407f, 0.0113863391f, -0.00201758207f},
+                 {-0.0109092886f, -0.0632580585f, 0.307905829f,
+                   0.89569293f, 0.307905829f, -0.0632580585f}}
+            }
+        }
+    },
+    /* 7 iterations */
+    {7,
+        { /* red */
+            {
+                {{-0.000624532381f, -0.00120603298f, 0.00852972553f,
+                   0.0180410818f, 0.00852972553f, -0.00120603298f},
+                 {-0.0180396939f, -0.0590865909f, 0.338118218f,
+                   0.874096253f, 0.338118218f, -0.0590865909f}},
+                {{-0.000957437418f, -0.0248652716f, 0.101133499f,
+                   0.515593432f, 0.101133499f, -0.0248652716f},
+                 {0.0012005845f, -0.0138683272f, -0.0470959621f,
+                   0.70546799f, 0.70546799f, -0.0470959621f}},
+                {{1.46538646e-05f, -0.00135532015f, 0.0016528712f,
+                   0.0154914806f, 0.0154914806f, 0.0016528712f},
+                 {-0.0182419769f, -0.0589895457f, 0.339044664f,
+                   0.873387159f, 0.339044664f, -0.0589895457f}},
+                {{1.60752094e-05f, -0.00132173056f, 0.00159872363f,
+                   0.0151762107f, 0.0151762107f, 0.00159872363f},
+                 {0.000743479005f, -0.0611300853f, 0.0739410245f,
+                   0.701900281f, 0.701900281f, 0.0739410245f}}
+            },
+            {
+                {{-0.00135532035f, 0.00165287179f, 0.0154914805f,
+                   0.0154914805f, 0.00165287179f, -0.00135532035f},
+                 {-0.0182405905f, -0.0589880344f, 0.339030399f,
+                   0.873398466f, 0.339030399f, -0.0589880344f}},
+                {{-0.00801234668f, -0.0222628534f, 0.363099068f,
+                   0.363099068f, -0.0222628534f, -0.00801234668f},
+                 {0.00134570146f, -0.0155770405f, -0.0432574417f,
+                   0.705695803f, 0.705695803f, -0.0432574417f}},
+                {{-0.000417651219f, -0.00132530526f, 0.00766734259f,
+                   0.0196552161f, 0.00766734259f, -0.00132530526f},
+                 {-0.0185377385f, -0.0588245913f, 0.340320308f,
+                   0.872410375f, 0.340320308f, -0.0588245913f}},
+                {{-0.000402678165f, -0.00130215065f, 0.00748416052f,
+                   0.0192793764f, 0.00748416052f, -0.00130215065f},
+                 {0.00066384394f, -0.0613982108f, 0.0748777582f,
+                   0.701789307f, 0.701789307f, 0.0748777582f}}
+            },
+            {
+                {{-0.00132427078f, 0.0016019395f, 0.0152045083f,
+                   0.0152045083f, 0.0016019395f, -0.00132427078f},
+                 {-0.0610195684f, 0.0738139497f, 0.70059126f,
+                   0.70059126f, 0.0738139497f, -0.0610195684f}},
+                {{-0.00743656398f, -0.0252534591f, 0.378284843f,
+                   0.378284843f, -0.0252534591f, -0.00743656398f},
+                 {-0.00178749613f, -0.0463778739f, 0.188641242f,
+                   0.961521687f, 0.188641242f, -0.0463778739f}},
+                {{-0.000403405698f, -0.00130456902f, 0.00749793681f,
+                   0.0193159272f, 0.00749793681f, -0.00130456902f},
+                 {-0.0612828316f, 0.0747370642f, 0.700470403f,
+                   0.700470403f, 0.0747370642f, -0.0612828316f}},
+                {{-0.000392872949f, -0.0012868025f, 0.00736362282f,
+                   0.019036286f, 0.00736362282f, -0.0012868025f},
+                 {-0.0286768865f, -0.0553778666f, 0.391662592f,
+                   0.828399087f, 0.391662592f, -0.0553778666f}}
+            }
+        },
+        { /* blue */
+            {
+                {{-0.000392872949f, -0.0012868025f, 0.00736362282f,
+                   0.019036286f, 0.00736362282f, -0.0012868025f},
+                 {-0.0286768865f, -0.0553778666f, 0.391662592f,
+                   0.828399087f, 0.391662592f, -0.0553778666f}},
+                {{-0.000402678165f, -0.00130215065f, 0.00748416052f,
+                   0.0192793764f, 0.00748416052f, -0.00130215065f},
+                 {0.00066384394f, -0.0613982108f, 0.0748777582f,
+                   0.701789307f, 0.701789307f, 0.0748777582f}},
+                {{0.000643775345f, -0.00743645047f, -0.0252537155f,
+                   0.378284827f, 0.378284827f, -0.0252537155f},
+                 {-0.00178553672f, -0.0463715484f, 0.188605097f,
+                   0.961536482f, 0.188605097f, -0.0463715484f}},
+                {{1.60752094e-05f, -0.00132173056f, 0.00159872363f,
+                   0.0151762107f, 0.0151762107f, 0.00159872363f},
+                 {0.000743479005f, -0.0611300853f, 0.0739410245f,
+                   0.701900281f, 0.701900281f, 0.0739410245f}}
+            },
+            {
+                {{-0.000403405698f, -0.00130456902f, 0.00749793681f,
+                   0.0193159272f, 0.00749793681f, -0.00130456902f},
+                 {-0.0612828316f, 0.0747370642f, 0.700470403f,
+                   0.700470403f, 0.0747370642f, -0.0612828316f}},
+                {{-0.000417651219f, -0.00132530526f, 0.00766734259f,
+                   0.0196552161f, 0.00766734259f, -0.00132530526f},
+                 {-0.0185377385f, -0.0588245913f, 0.340320308f,
+                   0.872410375f, 0.340320308f, -0.0588245913f}},
+                {{0.000692482768f, -0.00801576902f, -0.0222597907f,
+                   0.363143086f, 0.363143086f, -0.0222597907f},
+                 {-0.0155703899f, -0.0432633935f, 0.705610262f,
+                   0.705610262f, -0.0432633935f, -0.0155703899f}},
+                {{1.46538646e-05f, -0.00135532015f, 0.0016528712f,
+                   0.0154914806f, 0.0154914806f, 0.0016528712f},
+                 {-0.0182419769f, -0.0589895457f, 0.339044664f,
+                   0.873387159f, 0.339044664f, -0.0589895457f}}
+            },
+            {
+                {{-0.00132427078f, 0.0016019395f, 0.0152045083f,
+                   0.0152045083f, 0.0016019395f, -0.00132427078f},
+                 {-0.0610195684f, 0.0738139497f, 0.70059126f,
+                   0.70059126f, 0.0738139497f, -0.0610195684f}},
+                {{-0.00135532035f, 0.00165287179f, 0.0154914805f,
+                   0.0154914805f, 0.00165287179f, -0.00135532035f},
+                 {-0.0182405905f, -0.0589880344f, 0.339030399f,
+                   0.873398466f, 0.339030399f, -0.0589880344f}},
+                {{-0.000958579568f, -0.024871037f, 0.101162535f,
+                   0.515634707f, 0.101162535f, -0.024871037f},
+                 {-0.0138672154f, -0.0470909895f, 0.705400694f,
+                   0.705400694f, -0.0470909895f, -0.0138672154f}},
+                {{-0.000624532381f, -0.00120603298f, 0.00852972553f,
+                   0.0180410818f, 0.00852972553f, -0.00120603298f},
+                 {-0.0180396939f, -0.0590865909f, 0.338118218f,
+                   0.874096253f, 0.338118218f, -0.0590865909f}}
+            }
+        }
+    },
+    /* 8 iterations */
+    {8,
+        { /* red */
+            {
+                {{-0.000571726608f, -0.000691728764f, 0.00637486687f,
+                   0.0128554064f, 0.00637486687f, -0.000691728764f},
+                 {-0.0252061612f, -0.0524487931f, 0.362397173f,
+                   0.855102027f, 0.362397173f, -0.0524487931f}},
+                {{-0.00150991715f, -0.0255321129f, 0.107288121f,
+                   0.527927445f, 0.107288121f, -0.0255321129f},
+                 {0.00110013001f, -0.0152865826f, -0.043218463f,
+                   0.70570158f, 0.70570158f, -0.043218463f}},
+                {{-4.44506155e-05f, -0.00104790607f, 0.00155387047f,
+                   0.0111289835f, 0.0111289835f, 0.00155387047f},
+                 {-0.0253899868f, -0.0522903255f, 0.363049327f,
+                   0.854562557f, 0.363049327f, -0.0522903255f}},
+                {{-4.2135834e-05f, -0.00102722286f, 0.00151559982f,
+                   0.0109358566f, 0.0109358566f, 0.00151559982f},
+                 {-0.0026928558f, -0.0656487072f, 0.096860353f,
+                   0.698898827f, 0.698898827f, 0.096860353f}}
+            },
+            {
+                {{-0.00104790613f, 0.0015538707f, 0.0111289834f,
+                   0.0111289834f, 0.0015538707f, -0.00104790613f},
+                 {-0.0253881747f, -0.0522908712f, 0.36303949f,
+                   0.854570902f, 0.36303949f, -0.0522908712f}},
+                {{-0.00902516092f, -0.0207531674f, 0.3738001f,
+                   0.3738001f, -0.0207531674f, -0.00902516092f},
+                 {0.00122539748f, -0.0170501973f, -0.0391768395f,
+                   0.705917183f, 0.705917183f, -0.0391768395f}},
+                {{-0.000415513927f, -0.000843816068f, 0.00589765324f,
+                   0.0138383799f, 0.00589765324f, -0.000843816068f},
+                 {-0.0256381621f, -0.0520653863f, 0.363898728f,
+                   0.85385977f, 0.363898728f, -0.0520653863f}},
+                {{-0.000404361073f, -0.000832776019f, 0.00578192563f,
+                   0.0136097681f, 0.00578192563f, -0.000832776019f},
+                 {-0.00279107119f, -0.0657984238f, 0.0975681223f,
+                   0.698793138f, 0.698793138f, 0.0975681223f}}
+            },
+            {
+                {{-0.00102945003f, 0.00151892541f, 0.0109593467f,
+                   0.0109593467f, 0.00151892541f, -0.00102945003f},
+                 {-0.0655091846f, 0.0966570133f, 0.697399433f,
+                   0.697399433f, 0.0966570133f, -0.0655091846f}},
+                {{-0.00841520514f, -0.0237908055f, 0.388478917f,
+                   0.388478917f, -0.0237908055f, -0.00841520514f},
+                 {-0.00274574176f, -0.0463878126f, 0.194940777f,
+                   0.95900208f, 0.194940777f, -0.0463878126f}},
+                {{-0.000405204961f, -0.000834582269f, 0.00579424887f,
+                   0.0136392779f, 0.00579424887f, -0.000834582269f},
+                 {-0.0656567085f, 0.0973579909f, 0.697288045f,
+                   0.697288045f, 0.0973579909f, -0.0656567085f}},
+                {{-0.000396805487f, -0.000825669912f, 0.00570500147f,
+                   0.0134613586f, 0.00570500147f, -0.000825669912f},
+                 {-0.0363176254f, -0.043940488f, 0.404948841f,
+                   0.816610293f, 0.404948841f, -0.043940488f}}
+            }
+        },
+        { /* blue */
+            {
+                {{-0.000396805487f, -0.000825669912f, 0.00570500147f,
+                   0.0134613586f, 0.00570500147f, -0.000825669912f},
+                 {-0.0363176254f, -0.043940488f, 0.404948841f,
+                   0.816610293f, 0.404948841f, -0.043940488f}},
+                {{-0.000404361073f, -0.000832776019f, 0.00578192563f,
+                   0.0136097681f, 0.00578192563f, -0.000832776019f},
+                 {-0.00279107119f, -0.0657984238f, 0.0975681223f,
+                   0.698793138f, 0.698793138f, 0.0975681223f}},
+                {{0.000605606257f, -0.00841505098f, -0.0237911624f,
+                   0.388478898f, 0.388478898f, -0.0237911624f},
+                 {-0.00274287979f, -0.0463810326f, 0.194897063f,
+                   0.959020514f, 0.194897063f, -0.0463810326f}},
+                {{-4.2135834e-05f, -0.00102722286f, 0.00151559982f,
+                   0.0109358566f, 0.0109358566f, 0.00151559982f},
+                 {-0.0026928558f, -0.0656487072f, 0.096860353f,
+                   0.698898827f, 0.698898827f, 0.096860353f}}
+            },
+            {
+                {{-0.000405204961f, -0.000834582269f, 0.00579424887f,
+                   0.0136392779f, 0.00579424887f, -0.000834582269f},
+                 {-0.0656567085f, 0.0973579909f, 0.697288045f,
+                   0.697288045f, 0.0973579909f, -0.0656567085f}},
+                {{-0.000415513927f, -0.000843816068f, 0.00589765324f,
+                   0.0138383799f, 0.00589765324f, -0.000843816068f},
+                 {-0.0256381621f, -0.0520653863f, 0.363898728f,
+                   0.85385977f, 0.363898728f, -0.0520653863f}},
+                {{0.000648971854f, -0.00902980325f, -0.0207480973f,
+                   0.373854516f, 0.373854516f, -0.0207480973f},
+                 {-0.0170414316f, -0.039186413f, 0.705814434f,
+                   0.705814434f, -0.039186413f, -0.0170414316f}},
+                {{-4.44506155e-05f, -0.00104790607f, 0.00155387047f,
+                   0.0111289835f, 0.0111289835f, 0.00155387047f},
+                 {-0.0253899868f, -0.0522903255f, 0.363049327f,
+                   0.854562557f, 0.363049327f, -0.0522903255f}}
+            },
+            {
+                {{-0.00102945003f, 0.00151892541f, 0.0109593467f,
+                   0.0109593467f, 0.00151892541f, -0.00102945003f},
+                 {-0.0655091846f, 0.0966570133f, 0.697399433f,
+                   0.697399433f, 0.0966570133f, -0.0655091846f}},
+                {{-0.00104790613f, 0.0015538707f, 0.0111289834f,
+                   0.0111289834f, 0.0015538707f, -0.00104790613f},
+                 {-0.0253881747f, -0.0522908712f, 0.36303949f,
+                   0.854570902f, 0.36303949f, -0.0522908712f}},
+                {{-0.00151166831f, -0.0255388132f, 0.107324658f,
+                   0.527978657f, 0.107324658f, -0.0255388132f},
+                 {-0.0152850861f, -0.043212792f, 0.705619601f,
+                   0.705619601f, -0.043212792f, -0.0152850861f}},
+                {{-0.000571726608f, -0.000691728764f, 0.00637486687f,
+                   0.0128554064f, 0.00637486687f, -0.000691728764f},
+                 {-0.0252061612f, -0.0524487931f, 0.362397173f,
+                   0.855102027f, 0.362397173f, -0.0524487931f}}
+            }
+        }
+    },
+    /* 9 iterations */
+    {9,
+        { /* red */
+            {
+                {{-0.000490035884f, -0.000372657317f, 0.00475768519f,
+                   0.00921280269f, 0.00475768519f, -0.000372657317f},
+                 {-0.032024963f, -0.0442406925f, 0.382095559f,
+                   0.838490246f, 0.382095559f, -0.0442406925f}},
+                {{-0.0019820098f, -0.0258911549f, 0.111871763f,
+                   0.53673893f, 0.111871763f, -0.0258911549f},
+                 {0.000954382093f, -0.0163209332f, -0.0401428124f,
+                   0.70587174f, 0.70587174f, -0.0401428124f}},
+                {{-7.8767173e-05f, -0.000788021733f, 0.00136079925f,
+                   0.00803182838f, 0.00803182838f, 0.00136079925f},
+                 {-0.0321831232f, -0.0440578265f, 0.382564239f,
+                   0.838075932f, 0.382564239f, -0.0440578265f}},
+                {{-7.64057905e-05f, -0.000775156928f, 0.00133385206f,
+                   0.00791048281f, 0.00791048281f, 0.00133385206f},
+                 {-0.00671891727f, -0.0681651905f, 0.117295319f,
+                   0.695626329f, 0.695626329f, 0.117295319f}}
+            },
+            {
+                {{-0.000788021752f, 0.00136079933f, 0.00803182836f,
+                   0.00803182836f, 0.00136079933f, -0.000788021752f},
+                 {-0.0321814122f, -0.044059553f, 0.382558337f,
+                   0.838081205f, 0.382558337f, -0.044059553f}},
+                {{-0.00978509626f, -0.0194350632f, 0.381502283f,
+                   0.381502283f, -0.0194350632f, -0.00978509626f},
+                 {0.00105968575f, -0.0181175567f, -0.035951097f,
+                   0.706075658f, 0.706075658f, -0.035951097f}},
+                {{-0.000379721854f, -0.000513781512f, 0.00449252482f,
+                   0.00982050991f, 0.00449252482f, -0.000513781512f},
+                 {-0.0323851316f, -0.0438186047f, 0.383151524f,
+                   0.837556495f, 0.383151524f, -0.0438186047f}},
+                {{-0.000371643686f, -0.000508770169f, 0.00441776838f,
+                   0.00967791804f, 0.00441776838f, -0.000508770169f},
+                 {-0.0068209786f, -0.0682400952f, 0.117840748f,
+                   0.695529971f, 0.695529971f, 0.117840748f}}
+            },
+            {
+                {{-0.000776942935f, 0.00133691722f, 0.00792866117f,
+                   0.00792866117f, 0.00133691722f, -0.000776942935f},
+                 {-0.0680093105f, 0.117026379f, 0.694031383f,
+                   0.694031383f, 0.117026379f, -0.0680093105f}},
+                {{-0.0091524931f, -0.0225104661f, 0.395832285f,
+                   0.395832285f, -0.0225104661f, -0.0091524931f},
+                 {-0.00353812986f, -0.0461775617f, 0.199546186f,
+                   0.957123496f, 0.199546186f, -0.0461775617f}},
+                {{-0.00037247957f, -0.000509961566f, 0.00442787172f,
+                   0.00970026191f, 0.00442787172f, -0.000509961566f},
+                 {-0.0680833389f, 0.117570057f, 0.693932231f,
+                   0.693932231f, 0.117570057f, -0.0680833389f}},
+                {{-0.000366073137f, -0.000505709534f, 0.00436768404f,
+                   0.00958467165f, 0.00436768404f, -0.000505709534f},
+                 {-0.0428695238f, -0.0326009629f, 0.416213802f,
+                   0.80595825f, 0.416213802f, -0.0326009629f}}
+            }
+        },
+        { /* blue */
+            {
+                {{-0.000366073137f, -0.000505709534f, 0.00436768404f,
+                   0.00958467165f, 0.00436768404f, -0.000505709534f},
+                 {-0.0428695238f, -0.0326009629f, 0.416213802f,
+                   0.80595825f, 0.416213802f, -0.0326009629f}},
+                {{-0.000371643686f, -0.000508770169f, 0.00441776838f,
+                   0.00967791804f, 0.00441776838f, -0.000508770169f},
+                 {-0.0068209786f, -0.0682400952f, 0.117840748f,
+                   0.695529971f, 0.695529971f, 0.117840748f}},
+                {{0.000535189613f, -0.00915230283f, -0.0225109172f,
+                   0.395832263f, 0.395832263f, -0.0225109172f},
+                 {-0.00353443829f, -0.0461706544f, 0.199496411f,
+                   0.957144928f, 0.199496411f, -0.0461706544f}},
+                {{-7.64057905e-05f, -0.000775156928f, 0.00133385206f,
+                   0.00791048281f, 0.00791048281f, 0.00133385206f},
+                 {-0.00671891727f, -0.0681651905f, 0.117295319f,
+                   0.695626329f, 0.695626329f, 0.117295319f}}
+            },
+            {
+                {{-0.00037247957f, -0.000509961566f, 0.00442787172f,
+                   0.00970026191f, 0.00442787172f, -0.000509961566f},
+                 {-0.0680833389f, 0.117570057f, 0.693932231f,
+                   0.693932231f, 0.117570057f, -0.0680833389f}},
+                {{-0.000379721854f, -0.000513781512f, 0.00449252482f,
+                   0.00982050991f, 0.00449252482f, -0.000513781512f},
+                 {-0.0323851316f, -0.0438186047f, 0.383151524f,
+                   0.837556495f, 0.383151524f, -0.0438186047f}},
+                {{0.000572656888f, -0.00979077398f, -0.0194280648f,
+                   0.381565091f, 0.381565091f, -0.0194280648f},
+                 {-0.0181070503f, -0.0359640475f, 0.705959434f,
+                   0.705959434f, -0.0359640475f, -0.0181070503f}},
+                {{-7.8767173e-05f, -0.000788021733f, 0.00136079925f,
+                   0.00803182838f, 0.00803182838f, 0.00136079925f},
+                 {-0.0321831232f, -0.0440578265f, 0.382564239f,
+                   0.838075932f, 0.382564239f, -0.0440578265f}}
+            },
+            {
+                {{-0.000776942935f, 0.00133691722f, 0.00792866117f,
+                   0.00792866117f, 0.00133691722f, -0.000776942935f},
+                 {-0.0680093105f, 0.117026379f, 0.694031383f,
+                   0.694031383f, 0.117026379f, -0.0680093105f}},
+                {{-0.000788021752f, 0.00136079933f, 0.00803182836f,
+                   0.00803182836f, 0.00136079933f, -0.000788021752f},
+                 {-0.0321814122f, -0.044059553f, 0.382558337f,
+                   0.838081205f, 0.382558337f, -0.044059553f}},
+                {{-0.00198434326f, -0.0258984653f, 0.111914527f,
+                   0.536798149f, 0.111914527f, -0.0258984653f},
+                 {-0.0163191066f, -0.0401366809f, 0.705778105f,
+                   0.705778105f, -0.0401366809f, -0.0163191066f}},
+                {{-0.000490035884f, -0.000372657317f, 0.00475768519f,
+                   0.00921280269f, 0.00475768519f, -0.000372657317f},
+                 {-0.032024963f, -0.0442406925f, 0.382095559f,
+                   0.838490246f, 0.382095559f, -0.0442406925f}}
+            }
+        }
+    },
+    /* 10 iterations */
+    {10,
+        { /* red */
+            {
+                {{-0.000403142017f, -0.000179234108f, 0.00354729177f,
+                   0.00663227389f, 0.00354729177f, -0.000179234108f},
+                 {-0.0382773409f, -0.0350916889f, 0.398237501f,
+                   0.823945252f, 0.398237501f, -0.0350916889f}},
+                {{-0.00236908726f, -0.0260639181f, 0.115279861f,
+                   0.543058478f, 0.115279861f, -0.0260639181f},
+                 {0.000792816108f, -0.0170644982f, -0.0377281067f,
+                   0.70599623f, 0.70599623f, -0.0377281067f}},
+                {{-9.38203668e-05f, -0.000581039578f, 0.00114326002f,
+                   0.00581792225f, 0.00581792225f, 0.00114326002f},
+                 {-0.0384088836f, -0.0349045682f, 0.398580974f,
+                   0.823622799f, 0.398580974f, -0.0349045682f}},
+                {{-9.17435255e-05f, -0.000572992539f, 0.00112432343f,
+                   0.00574036989f, 0.00574036989f, 0.00112432343f},
+                 {-0.0110631861f, -0.0690961358f, 0.135580133f,
+                   0.692220841f, 0.692220841f, 0.135580133f}}
+            },
+            {
+                {{-0.000581039583f, 0.00114326005f, 0.00581792225f,
+                   0.00581792225f, 0.00114326005f, -0.000581039583f},
+                 {-0.0384076225f, -0.03490665f, 0.398578084f,
+                   0.823625478f, 0.398578084f, -0.03490665f}},
+                {{-0.0103439114f, -0.0183313875f, 0.387062914f,
+                   0.387062914f, -0.0183313875f, -0.0103439114f},
+                 {0.000879719301f, -0.0188807666f, -0.0334234796f,
+                   0.706189948f, 0.706189948f, -0.0334234796f}},
+                {{-0.000328611337f, -0.000295389082f, 0.00339936296f,
+                   0.00701365889f, 0.00339936296f, -0.000295389082f},
+                 {-0.0385707758f, -0.0346713117f, 0.399000436f,
+                   0.823228643f, 0.399000436f, -0.0346713117f}},
+                {{-0.000322856163f, -0.000293399701f, 0.00335037917f,
+                   0.00692318213f, 0.00335037917f, -0.000293399701f},
+                 {-0.0111614272f, -0.0691239137f, 0.136008991f,
+                   0.69213453f, 0.69213453f, 0.136008991f}}
+            },
+            {
+                {{-0.000574326796f, 0.00112691342f, 0.00575371039f,
+                   0.00575371039f, 0.00112691342f, -0.000574326796f},
+                 {-0.0689363453f, 0.135263222f, 0.690616855f,
+                   0.690616855f, 0.135263222f, -0.0689363453f}},
+                {{-0.00969633463f, -0.0214367239f, 0.401149836f,
+                   0.401149836f, -0.0214367239f, -0.00969633463f},
+                 {-0.00417382623f, -0.0458775525f, 0.202939107f,
+                   0.955721988f, 0.202939107f, -0.0458775525f}},
+                {{-0.000323595878f, -0.000294099122f, 0.00335814134f,
+                   0.00693929465f, 0.00335814134f, -0.000294099122f},
+                 {-0.0689636381f, 0.135693633f, 0.690529691f,
+                   0.690529691f, 0.135693633f, -0.0689636381f}},
+                {{-0.000318830692f, -0.000292295838f, 0.0033171149f,
+                   0.00686304296f, 0.0033171149f, -0.000292295838f},
+                 {-0.0483993693f, -0.0215180195f, 0.425871472f,
+                   0.796240183f, 0.425871472f, -0.0215180195f}}
+            }
+        },
+        { /* blue */
+            {
+                {{-0.000318830692f, -0.000292295838f, 0.0033171149f,
+                   0.00686304296f, 0.0033171149f, -0.000292295838f},
+                 {-0.0483993693f, -0.0215180195f, 0.425871472f,
+                   0.796240183f, 0.425871472f, -0.0215180195f}},
+                {{-0.000322856163f, -0.000293399701f, 0.00335037917f,
+                   0.00692318213f, 0.00335037917f, -0.000293399701f},
+                 {-0.0111614272f, -0.0691239137f, 0.136008991f,
+                   0.69213453f, 0.69213453f, 0.136008991f}},
+                {{0.000450481204f, -0.00969611441f, -0.0214372574f,
+                   0.401149811f, 0.401149811f, -0.0214372574f},
+                 {-0.00416943154f, -0.0458707132f, 0.202884671f,
+                   0.955745778f, 0.202884671f, -0.0458707132f}},
+                {{-9.17435255e-05f, -0.000572992539f, 0.00112432343f,
+                   0.00574036989f, 0.00574036989f, 0.00112432343f},
+                 {-0.0110631861f, -0.0690961358f, 0.135580133f,
+                   0.692220841f, 0.692220841f, 0.135580133f}}
+            },
+            {
+                {{-0.000323595878f, -0.000294099122f, 0.00335814134f,
+                   0.00693929465f, 0.00335814134f, -0.000294099122f},
+                 {-0.0689636381f, 0.135693633f, 0.690529691f,
+                   0.690529691f, 0.135693633f, -0.0689636381f}},
+                {{-0.000328611337f, -0.000295389082f, 0.00339936296f,
+                   0.00701365889f, 0.00339936296f, -0.000295389082f},
+                 {-0.0385707758f, -0.0346713117f, 0.399000436f,
+                   0.823228643f, 0.399000436f, -0.0346713117f}},
+                {{0.000482260702f, -0.0103504058f, -0.0183226976f,
+                   0.38713219f, 0.38713219f, -0.0183226976f},
+                 {-0.0188689198f, -0.0334393314f, 0.706063577f,
+                   0.706063577f, -0.0334393314f, -0.0188689198f}},
+                {{-9.38203668e-05f, -0.000581039578f, 0.00114326002f,
+                   0.00581792225f, 0.00581792225f, 0.00114326002f},
+                 {-0.0384088836f, -0.0349045682f, 0.398580974f,
+                   0.823622799f, 0.398580974f, -0.0349045682f}}
+            },
+            {
+                {{-0.000574326796f, 0.00112691342f, 0.00575371039f,
+                   0.00575371039f, 0.00112691342f, -0.000574326796f},
+                 {-0.0689363453f, 0.135263222f, 0.690616855f,
+                   0.690616855f, 0.135263222f, -0.0689363453f}},
+                {{-0.000581039583f, 0.00114326005f, 0.00581792225f,
+                   0.00581792225f, 0.00114326005f, -0.000581039583f},
+                 {-0.0384076225f, -0.03490665f, 0.398578084f,
+                   0.823625478f, 0.398578084f, -0.03490665f}},
+                {{-0.00237192888f, -0.0260715913f, 0.115327544f,
+                   0.543123852f, 0.115327544f, -0.0260715913f},
+                 {-0.017062407f, -0.0377216877f, 0.705893723f,
+                   0.705893723f, -0.0377216877f, -0.017062407f}},
+                {{-0.000403142017f, -0.000179234108f, 0.00354729177f,
+                   0.00663227389f, 0.00354729177f, -0.000179234108f},
+                 {-0.0382773409f, -0.0350916889f, 0.398237501f,
+                   0.823945252f, 0.398237501f, -0.0350916889f}}
+            }
+        }
+    },
+    /* 20 iterations */
+    {20,
+        { /* red */
+            {
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{-0.00359331773f, -0.0258379851f, 0.124581974f,
+                   0.558905735f, 0.124581974f, -0.0258379851f},
+                 {-7.86366111e-05f, -0.0187355072f, -0.0301950174f,
+                   0.70633756f, 0.70633756f, -0.0301950174f}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}}
+            },
+            {
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{-0.0116756017f, -0.0145267557f, 0.401232339f,
+                   0.401232339f, -0.0145267557f, -0.0116756017f},
+                 {-6.90477176e-05f, -0.0205690045f, -0.0255489203f,
+                   0.70649537f, 0.70649537f, -0.0255489203f}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}}
+            },
+            {
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{-0.0110011737f, -0.0177287014f, 0.414738127f,
+                   0.414738127f, -0.0177287014f, -0.0110011737f},
+                 {-0.00612611347f, -0.0440101697f, 0.212240454f,
+                   0.951838568f, 0.212240454f, -0.0440101697f}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}}
+            }
+        },
+        { /* blue */
+            {
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{-4.61728221e-05f, -0.0110008713f, -0.0177295175f,
+                   0.414738098f, 0.414738098f, -0.0177295175f},
+                 {-0.00611975434f, -0.0440044921f, 0.212174691f,
+                   0.951868457f, 0.212174691f, -0.0440044921f}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}}
+            },
+            {
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{-3.92218674e-05f, -0.0116840179f, -0.0145128094f,
+                   0.401317649f, 0.401317649f, -0.0145128094f},
+                 {-0.0205541884f, -0.025573472f, 0.706345187f,
+                   0.706345187f, -0.025573472f, -0.0205541884f}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}}
+            },
+            {
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}},
+                {{-0.00359768287f, -0.0258458539f, 0.124642458f,
+                   0.558986268f, 0.124642458f, -0.0258458539f},
+                 {-0.0187327346f, -0.0301883297f, 0.706213671f,
+                   0.706213671f, -0.0301883297f, -0.0187327346f}},
+                {{0, 0, 0,
+                   0, 0, 0},
+                 {0, 0, 0,
+                   0, 0, 0}}
+            }
+        }
+    }
+};
+
+/** @brief Number of entries in FilterBanks */
+#define NUM_FILTER_BANKS   ((int)(sizeof(FilterBanks)/sizeof(*FilterBanks)))
+
+
+/**
+ * @brief Get the filter bank for a number of iterations
+ * @param NumIter the number of Gunturk iterations
+ * @return pointer to the filter bank, or NULL if there are no
+ *    precomputed filters for NumIter
+ */
+const onestepfilterbank *GetOneStepFilters(int NumIter)
+{
+    int i;
+    
+    for(i = 0; i < NUM_FILTER_BANKS; i++)
+        if(FilterBanks[i].NumIter == NumIter)
+            return &FilterBanks[i];
+    
+    return NULL;
+}
+
+
+/** @brief Print the numbers of iterations with precomputed filters */
+void PrintOneStepIterChoices()
+{
+    int i;
+    
+    for(i = 0; i < NUM_FILTER_BANKS; i++)
+        printf((i == 0) ? "%d" : ", %d", FilterBanks[i].NumIter);
+}
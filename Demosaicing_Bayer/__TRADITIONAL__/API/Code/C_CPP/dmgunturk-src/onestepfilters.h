@@ -0,0 +1,63 @@
+/**
+ * @file onestepfilters.h
+ * @brief Precomputed polyphase filters for one-step Gunturk demosaicing
+ * @author Demosaicing_Bayer contributors
+ * 
+ * 
+ * Copyright (c) 2026, Demosaicing_Bayer contributors
+ * All rights reserved.
+ * 
+ * This program is free software: you can use, modify and/or 
+ * redistribute it under the terms of the simplified BSD License. You 
+ * should have received a copy of this license along this program. If 
+ * not, see <http://www.opensource.org/licenses/bsd-license.html>.
+ */
+
+#ifndef _ONESTEPFILTERS_H_
+#define _ONESTEPFILTERS_H_
+
+/** @brief Number of taps in each 1D polyphase filter */
+#define ONESTEP_TAPS        6
+/** @brief Filter delay, taps span offsets -3 to 2 as with conv2 'same' */
+#define ONESTEP_DELAY       (-3)
+
+
+/** 
+ * @brief A separable 2D polyphase filter 
+ *
+ * The 2D filter is the outer product Vert * Horiz^T.  A filter whose 
+ * coefficients are all zero contributes nothing and is skipped.
+ */
+typedef struct
+{
+    /** @brief Vertical filter coefficients */
+    float Vert[ONESTEP_TAPS];
+    /** @brief Horizontal filter coefficients */
+    float Horiz[ONESTEP_TAPS];
+} onestepfilter;
+
+/** 
+ * @brief Polyphase filters equivalent to a number of Gunturk iterations 
+ *
+ * Red[m][c] maps the red color difference on sublattice c to the 
+ * interpolated red on output sublattice m, with the GRBG sublattices
+ * numbered c = 0 (00, green), 1 (01, red), 2 (10, blue), 3 (11, green)
+ * and outputs m = 0 (00), 1 (10), 2 (11).  Blue[m][c] is similar with
+ * outputs m = 0 (00), 1 (01), 2 (11).
+ */
+typedef struct
+{
+    /** @brief Number of Gunturk iterations the filters represent */
+    int NumIter;
+    /** @brief Red channel filters */
+    onestepfilter Red[3][4];
+    /** @brief Blue channel filters */
+    onestepfilter Blue[3][4];
+} onestepfilterbank;
+
+
+const onestepfilterbank *GetOneStepFilters(int NumIter);
+
+void PrintOneStepIterChoices();
+
+#endif /* _ONESTEPFILTERS_H_ */
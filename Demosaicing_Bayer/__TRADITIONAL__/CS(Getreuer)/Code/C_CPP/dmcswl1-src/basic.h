@@ -154,7 +154,7 @@ void *ReallocWithErrorMessage(void *Ptr, size_t Size);
     #endif
     #ifndef ATTRIBUTE_ALWAYSINLINE
     /** @brief Macro for the always inline attribue GNU extension */
-    #define ATTRIBUTE_ALWAYSINLINE __attribute__((always_inline))
+    #define ATTRIBUTE_ALWAYSINLINE __inline__ __attribute__((always_inline))
     #endif
 #else
     #define ATTRIBUTE_UNUSED
@@ -50,6 +50,9 @@ int IsNullFilter(filter Filter);
 
 filter GaussianFilter(double Sigma, int R);
 
+int RecursiveGaussian2D(float *Data, int Width, int Height, 
+    int NumChannels, double Sigma);
+
 boundaryext GetBoundaryExt(const char *Boundary);
 
 
@@ -29,6 +29,7 @@
  * @param Image the input RGB image in planar row-major order
  * @param Width, Height the image dimensions
  * @param RedX, RedY the coordinates of the upper-leftmost red pixel
+ * @param Radius radius of the mosaiced contour stencils, zero for default
  * @param OutputFile EPS file to write
  * @return 1 on success, 0 on failure
  * 
@@ -57,7 +58,7 @@ gs -dSAFER -q -P- -dCompatibilityLevel=1.4 -dNOPAUSE -dBATCH \
  * which significantly decreases the file size.
  */
 int DisplayContours(const float *Image, int Width, int Height, 
-    int RedX, int RedY, const char *OutputFile)
+    int RedX, int RedY, float Radius, const char *OutputFile)
 {
     const int NumPixels = Width*Height;
     FILE *File = NULL;
@@ -77,7 +78,9 @@ int DisplayContours(const float *Image, int Width, int Height,
 
     CfaFlatten(Mosaic, Image, Width, Height, RedX, RedY);
     /* Estimate the contour orientations */
-    FitMosaicedStencils(Stencil, Mosaic, Width, Height, RedX, RedY);
+    if(!FitMosaicedStencils(Stencil, Mosaic, Width, Height, 
+        RedX, RedY, Radius))
+        goto Catch;
 
     /* Lighten the image according to 0.5 + 0.5*Image and convert to
        unsigned 8-bit data.                                          */
@@ -15,6 +15,6 @@
 #define _DISPLAYCONTOURS_H_
 
 int DisplayContours(const float *Image, int Width, int Height, 
-    int RedX, int RedY, const char *OutputFile);
+    int RedX, int RedY, float Radius, const char *OutputFile);
 
 #endif /* _DISPLAYCONTOURS_H_ */
@@ -16,14 +16,27 @@
 #ifndef _DMCSWL1_H_
 #define _DMCSWL1_H_
 
+/** @brief Four-color Gauss-Seidel ordering, parallelizable */
+#define GS_ORDER_MULTICOLOR     0
+/** @brief Lexicographic Gauss-Seidel ordering, as in the original method */
+#define GS_ORDER_LEXICOGRAPHIC  1
+
 int CSWL1Demosaic(float *Image, int Width, int Height, 
     int RedX, int RedY, float Alpha, float Epsilon, float Sigma, 
-    float Tol, int MaxIter, int ShowEnergy);
+    float Radius, float Tol, int MaxIter, int ShowEnergy, int Ordering, 
+    int NumThreads, int WarmStart);
+
+int CSWL1DemosaicTiled(float *Image, int Width, int Height, 
+    int RedX, int RedY, float Alpha, float Epsilon, float Sigma,
+    float Radius, float Tol, int MaxIter, int Ordering, int TileSize, 
+    int Halo, int NumThreads);
 
 int DisplayContours(const float *Image, int Width, int Height, 
-    int RedX, int RedY, const char *OutputFile);
+    int RedX, int RedY, float Radius, const char *OutputFile);
 
-void FitMosaicedStencils(int *Stencil, 
-    const float *Input, int Width, int Height, int RedX, int RedY);
+int FitMosaicedStencils(int *Stencil, const float *Input, 
+    int Width, int Height, int RedX, int RedY, float Radius);
+int IsMosaicedStencilRadius(float Radius);
+const char *MosaicedStencilRadii();
 
 #endif /* _DMCSWL1_H_ */
@@ -31,6 +31,7 @@
 #define DEFAULT_SIGMA           0.6
 #define DEFAULT_TOL             0.001
 #define DEFAULT_MAXITER         250
+#define DEFAULT_HALO            16
 
 /* Print verbose information if nonzero */
 #define VERBOSE 1
@@ -59,10 +60,22 @@ typedef struct
     float Epsilon;
     /** @brief Graph spatial filtering parameter */
     float Sigma;
+    /** @brief Mosaiced contour stencil radius, or zero for the default */
+    float Radius;
     /** @brief Convergence tolerance */
     float Tol;
     /** @brief Maximum number of iterations */
     int MaxIter;
+    /** @brief Gauss-Seidel ordering for the u-subproblem */
+    int Ordering;
+    /** @brief Number of threads */
+    int NumThreads;
+    /** @brief Tile size, or zero to process the image as a whole */
+    int TileSize;
+    /** @brief Overlap between tiles */
+    int Halo;
+    /** @brief Name of the initialization method */
+    const char *Initialization;
 } programparams;
 
 
@@ -83,12 +96,28 @@ static void PrintHelpMessage()
     printf("                 BGGR        upperleftmost red pixel is at (1,1)\n\n");
     printf("   -s            Show estimated contours instead of demosaicing.\n"
            "                 The output is written as an EPS file.\n");
-    printf("   -E            Display energy value after each iteration.\n\n");
+    printf("   -E            Display the energy of d after each iteration.\n\n");
     printf("   -a <number>   alpha, chroma weight (default 1.8)\n");
     printf("   -e <number>   epsilon, graph weight (default 0.15)\n");
     printf("   -f <number>   sigma, graph spatial filtering parameter (default 0.6)\n");
+    printf("   -r <number>   radius of the mosaiced contour stencils, one of\n"
+           "                 %s (default is the first)\n", 
+           MosaicedStencilRadii());
     printf("   -t <number>   convergence tolerance (default 0.001)\n");
-    printf("   -m <number>   maximum number of iterations (default 250)\n\n");    
+    printf("   -m <number>   maximum number of iterations (default 250)\n");
+    printf("   -o <order>    Gauss-Seidel ordering, choices for <order> are\n");
+    printf("                 multicolor  four-color ordering (default with -j > 1)\n");
+    printf("                 lex         lexicographic ordering, as in the\n"
+           "                             original method (default otherwise)\n");
+    printf("   -j <number>   number of threads (default 1), requires a build\n"
+           "                 with OpenMP and multicolor ordering or tiling\n");
+    printf("   -T <number>   process the image in tiles of this size to bound\n"
+           "                 the working set per tile (default 0, no tiling)\n");
+    printf("   -H <number>   overlap between tiles, at most tile size/4\n"
+           "                 (default 16 or tile size/4 if smaller)\n");
+    printf("   -i <init>     initialization, choices for <init> are\n");
+    printf("                 bilinear    bilinear interpolation (default)\n");
+    printf("                 input       input file is the initial demosaicing\n\n");
 #ifdef LIBJPEG_SUPPORT
     printf("   -q <number>   Quality for saving JPEG images (0 to 100)\n\n");
 #endif
@@ -102,11 +131,35 @@ int main(int argc, char *argv[])
 {
     programparams Param;
     float *Image = NULL;
-    int Width, Height, Status = 1;
+    int Width, Height, WarmStart = 0, Status = 1;
         
     if(!ParseParams(&Param, argc, argv))
         return 0;
-
+    
+    if(Param.ShowEnergy && Param.TileSize)
+    {
+        ErrorMessage("Energy display cannot be used with tiling.\n");
+        goto Catch;
+    }
+    
+    if(!strcmp(Param.Initialization, "input"))
+    {
+        if(Param.TileSize)
+        {
+            ErrorMessage("Initialization \"%s\" cannot be used with tiling.\n",
+                Param.Initialization);
+            goto Catch;
+        }
+        
+        WarmStart = 1;
+    }
+    else if(strcmp(Param.Initialization, "bilinear"))
+    {
+        ErrorMessage("Unknown initialization, \"%s\".\n", 
+            Param.Initialization);
+        goto Catch;
+    }
+    
     /* Read the input image */
     if(!(Image = (float *)ReadImage(&Width, &Height, 
         Param.InputFile, IMAGEIO_FLOAT | IMAGEIO_RGB | IMAGEIO_PLANAR)))
@@ -121,7 +174,7 @@ int main(int argc, char *argv[])
     if(Param.ShowContours)
     {    
         if(!(DisplayContours(Image, Width, Height, 
-            Param.RedX, Param.RedY, Param.OutputFile)))
+            Param.RedX, Param.RedY, Param.Radius, Param.OutputFile)))
             goto Catch;
 #if VERBOSE > 0
         else
@@ -131,9 +184,15 @@ int main(int argc, char *argv[])
     else
     {   
         /* Perform demosaicing */
-        if(!(CSWL1Demosaic(Image, Width, Height, Param.RedX, Param.RedY,
-            Param.Alpha, Param.Epsilon, Param.Sigma, 
-            Param.Tol, Param.MaxIter, Param.ShowEnergy)))
+        if(!((Param.TileSize) ? 
+            CSWL1DemosaicTiled(Image, Width, Height, Param.RedX, Param.RedY,
+            Param.Alpha, Param.Epsilon, Param.Sigma, Param.Radius,
+            Param.Tol, Param.MaxIter, Param.Ordering, 
+            Param.TileSize, Param.Halo, Param.NumThreads) :
+            CSWL1Demosaic(Image, Width, Height, Param.RedX, Param.RedY,
+            Param.Alpha, Param.Epsilon, Param.Sigma, Param.Radius,
+            Param.Tol, Param.MaxIter, Param.ShowEnergy,
+            Param.Ordering, Param.NumThreads, WarmStart)))
         {
             ErrorMessage("Error in computation.\n");
             goto Catch;
@@ -163,6 +222,7 @@ Catch:
 static int ParseParams(programparams *Param, int argc, char *argv[])
 {
     static char *DefaultOutputFile = (char *)"out.bmp";
+    static const char *DefaultInitialization = (char *)"bilinear";
     char *OptionString;
     char OptionChar;
     int i;
@@ -184,8 +244,14 @@ static int ParseParams(programparams *Param, int argc, char *argv[])
     Param->Alpha = (float)DEFAULT_ALPHA;
     Param->Epsilon = (float)DEFAULT_EPSILON;
     Param->Sigma = (float)DEFAULT_SIGMA;
+    Param->Radius = 0;
     Param->Tol = (float)DEFAULT_TOL;
     Param->MaxIter = DEFAULT_MAXITER;
+    Param->Ordering = -1;
+    Param->NumThreads = 1;
+    Param->TileSize = 0;
+    Param->Halo = -1;
+    Param->Initialization = DefaultInitialization;
     
     for(i = 1; i < argc;)
     {
@@ -272,6 +338,17 @@ static int ParseParams(programparams *Param, int argc, char *argv[])
                     return 0;
                 }
                 break;
+            case 'r':
+                Param->Radius = (float)atof(OptionString);
+
+                if(Param->Radius <= 0 
+                    || !IsMosaicedStencilRadius(Param->Radius))
+                {
+                    ErrorMessage("Stencil radius must be one of %s.\n",
+                        MosaicedStencilRadii());
+                    return 0;
+                }
+                break;
             case 't':
                 Param->Tol = (float)atof(OptionString);
 
@@ -290,6 +367,47 @@ static int ParseParams(programparams *Param, int argc, char *argv[])
                     return 0;
                 }
                 break;
+            case 'o':
+                if(!strcmp(OptionString, "multicolor"))
+                    Param->Ordering = GS_ORDER_MULTICOLOR;
+                else if(!strcmp(OptionString, "lex"))
+                    Param->Ordering = GS_ORDER_LEXICOGRAPHIC;
+                else
+                {
+                    ErrorMessage("Ordering must be multicolor or lex.\n");
+                    return 0;
+                }
+                break;
+            case 'j':
+                Param->NumThreads = atoi(OptionString);
+
+                if(Param->NumThreads <= 0)
+                {
+                    ErrorMessage("Number of threads must be positive.\n");
+                    return 0;
+                }
+                break;
+            case 'T':
+                Param->TileSize = atoi(OptionString);
+
+                if(Param->TileSize != 0 && Param->TileSize < 8)
+                {
+                    ErrorMessage("Tile size must be 0 or at least 8.\n");
+                    return 0;
+                }
+                break;
+            case 'i':
+                Param->Initialization = OptionString;
+                break;
+            case 'H':
+                Param->Halo = atoi(OptionString);
+
+                if(Param->Halo < 0)
+                {
+                    ErrorMessage("Halo must be nonnegative.\n");
+                    return 0;
+                }
+                break;
                 
 #ifdef LIBJPEG_SUPPORT
             case 'q':
@@ -333,5 +451,17 @@ static int ParseParams(programparams *Param, int argc, char *argv[])
         return 0;
     }
     
+    /* Without -H, use the default halo or a quarter of the tile size if 
+       that is smaller */
+    if(Param->Halo < 0)
+        Param->Halo = (Param->TileSize/4 < DEFAULT_HALO) ? 
+            Param->TileSize/4 : DEFAULT_HALO;
+    
+    /* Without -o, use the lexicographic ordering unless there are threads
+       to run the multicolor ordering in parallel */
+    if(Param->Ordering < 0)
+        Param->Ordering = (Param->NumThreads > 1) ?
+            GS_ORDER_MULTICOLOR : GS_ORDER_LEXICOGRAPHIC;
+    
     return 1;
 }
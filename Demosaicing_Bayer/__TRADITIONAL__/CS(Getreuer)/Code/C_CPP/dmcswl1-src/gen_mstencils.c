@@ -4,7 +4,8 @@
  * @author Pascal Getreuer <getreuer@gmail.com>
  * 
  * This program generates the source file mstencil.c by filling the 
- * template mstencil.tem.
+ * template mstencil.tem.  Stencils are generated for each radius given on
+ * the command line, so that the radius can be selected at runtime.
  * 
  * Copyright (c) 2010-2011, Pascal Getreuer
  * All rights reserved.
@@ -24,6 +25,9 @@
 /** @brief Number of stencils */
 #define NUMSTENCILS     8
 
+/** @brief Number of stencil TVs computed by the generated RowTV functions */
+#define NUMROWTVS       6
+
 /** @brief The constant 1 + (cot(pi/6) - 1)/sqrt(2) */
 #define WEIGHT_PI_8_FACTOR  3.847759065022573512
 
@@ -180,27 +184,105 @@ mstencil *ConstructMosaicedStencils(double Radius, cfa_color CenterPixel)
 /**
  * @brief Write TV computation code for an mstencil
  * @param Str the string to which to append
- * @param Stencils the mstencil array
- * @param j index of the mstencil to write
+ * @param Lhs the left-hand side of the assignment
+ * @param Macro the name of the macro for the absolute differences
+ * @param Stencil the mstencil to write
+ * @param Indent number of spaces to indent
  * 
- * Writes code for computing the TV of Stencils[j].
+ * Writes code for computing the TV of Stencil.
  */
-void WriteTVComputation(char **Str, mstencil *Stencils, int j)
+void WriteTVComputation(char **Str, const char *Lhs, const char *Macro,
+    mstencil Stencil, int Indent)
 {
-    edge *Edge = Stencils[j].Head;
+    edge *Edge = Stencil.Head;
+    
+    if(!Edge)
+    {
+        fprintf(stderr, "Stencil has no edges, radius is too small.\n");
+        exit(1);
+    }
     
-    if(Edge)
-        StringAppend(Str, "TV[%d] = TVEDGE(%2d,%2d,  %2d,%2d)",
-            2*j, Edge->x1, Edge->y1, Edge->x2, Edge->y2);
+    StringAppend(Str, "%*s%s = %s(%2d,%2d,  %2d,%2d)", Indent, "",
+        Lhs, Macro, Edge->x1, Edge->y1, Edge->x2, Edge->y2);
     
     for(Edge = Edge->NextEdge; Edge != NULL; Edge = Edge->NextEdge)
-        StringAppend(Str, "\n      + TVEDGE(%2d,%2d,  %2d,%2d)",
-            Edge->x1, Edge->y1, Edge->x2, Edge->y2);
+        StringAppend(Str, "\n%*s+ %s(%2d,%2d,  %2d,%2d)", 
+            Indent + (int)strlen(Lhs) + 1, "", 
+            Macro, Edge->x1, Edge->y1, Edge->x2, Edge->y2);
     
-    StringAppend(Str, ";");
+    StringAppend(Str, ";\n");
 }
 
 
+/**
+ * @brief Write the PixelTV function for one radius
+ * @param Str the string to which to append
+ * @param Radius the radius of the neighborhood
+ * @param Index index of the stencil set, used to name the function
+ * @param GreenStencils, RedBlueStencils the mstencils
+ */
+void WritePixelTV(char **Str, double Radius, int Index, 
+    mstencil *GreenStencils, mstencil *RedBlueStencils)
+{
+    StringAppend(Str, "/** @brief Stencil TVs at a pixel, radius %g */\n"
+        "static void PixelTV%d(float *TV, const float *Input, int Width,\n"
+        "    const int *HorizontalOffset, const int *VerticalOffset, "
+        "int IsGreen)\n{\n", Radius, Index);
+    WriteTVComputation(Str, "TV[0]", "TVEDGE", GreenStencils[0], 4);
+    WriteTVComputation(Str, "TV[Width]", "TVEDGE", GreenStencils[2], 4);
+    StringAppend(Str, "\n    if(IsGreen)  /* Center pixel is green */\n"
+        "    {\n");
+    WriteTVComputation(Str, "TV[2*Width]", "TVEDGE", GreenStencils[1], 8);
+    WriteTVComputation(Str, "TV[3*Width]", "TVEDGE", GreenStencils[3], 8);
+    StringAppend(Str, "    }\n"
+        "    else    /* Center pixel is red or blue */\n    {\n");
+    WriteTVComputation(Str, "TV[4*Width]", "TVEDGE", RedBlueStencils[1], 8);
+    WriteTVComputation(Str, "TV[5*Width]", "TVEDGE", RedBlueStencils[3], 8);
+    StringAppend(Str, "    }\n}\n\n\n");
+}
+
+
+/**
+ * @brief Write the RowTV function for one radius
+ * @param Str the string to which to append
+ * @param Radius the radius of the neighborhood
+ * @param Index index of the stencil set, used to name the function
+ * @param GreenStencils, RedBlueStencils the mstencils
+ * 
+ * Each of the NUMROWTVS stencil TVs is computed in its own loop over x so
+ * that the loops are simple enough for the compiler to vectorize.
+ */
+void WriteRowTV(char **Str, double Radius, int Index, 
+    mstencil *GreenStencils, mstencil *RedBlueStencils)
+{
+    static const char *Lhs[NUMROWTVS] = {"TV[x]", "TV[x + Width]", 
+        "TV[x + 2*Width]", "TV[x + 3*Width]", 
+        "TV[x + 4*Width]", "TV[x + 5*Width]"};
+    mstencil Stencils[NUMROWTVS];
+    int k;
+    
+    Stencils[0] = GreenStencils[0];
+    Stencils[1] = GreenStencils[2];
+    Stencils[2] = GreenStencils[1];
+    Stencils[3] = GreenStencils[3];
+    Stencils[4] = RedBlueStencils[1];
+    Stencils[5] = RedBlueStencils[3];
+    
+    StringAppend(Str, "/** @brief Stencil TVs along an interior row, "
+        "radius %g */\n"
+        "static void RowTV%d(float *RESTRICT TV, "
+        "const float *RESTRICT Input,\n"
+        "    int Width, int x0, int x1)\n{\n    int x;\n", Radius, Index);
+    
+    for(k = 0; k < NUMROWTVS; k++)
+    {
+        StringAppend(Str, "\n    for(x = x0; x < x1; x++)\n");
+        WriteTVComputation(Str, Lhs[k], "ROWTVEDGE", Stencils[k], 8);
+    }
+    
+    StringAppend(Str, "}\n\n\n");
+}
+
 
 int main(int argc, char *argv[])
 {
@@ -208,72 +290,83 @@ int main(int argc, char *argv[])
     char *TemplateFilename, *OutputFilename;
     char **Keys = NULL, **Subs = NULL, **Sub;
     mstencil *GreenStencils = NULL, *RedBlueStencils = NULL;
-    int Status = 1;        
+    int i, NumRadii, MaxRadius = 0, Status = 1;
     
-    if(argc != 4)
+    if(argc < 4)
     {
-        fprintf(stderr, "Syntax: gen-mstencil <radius> <template> <output>\n");
+        fprintf(stderr, "Syntax: gen_mstencils <template> <output> "
+            "<radius> [<radius> ...]\n");
         return 1;
     }
-    else if((Radius = atof(argv[1])) <= 0)
-        fprintf(stderr, "Radius must be positive.\n");
-    
-    TemplateFilename = argv[2];
-    OutputFilename = argv[3];
     
-    /* Construct stencils */
-    GreenStencils = ConstructMosaicedStencils(Radius, COLOR_GREEN);
-    RedBlueStencils = ConstructMosaicedStencils(Radius, COLOR_RED);    
+    TemplateFilename = argv[1];
+    OutputFilename = argv[2];
+    NumRadii = argc - 3;
     
-    /* Make sure that RedBlue axial stencils are the same as Green versions */
-    if(!StencilEquals(RedBlueStencils[0], GreenStencils[0])
-        || !StencilEquals(RedBlueStencils[2], GreenStencils[2]))
+    for(i = 0; i < NumRadii; i++)
     {
-        fprintf(stderr, "Assertion failed:\n"
-            "RedBlue axial stencils == Green axial stencils\n");
-        goto Catch;
+        if((Radius = atof(argv[3 + i])) <= 0)
+        {
+            fprintf(stderr, "Radius must be positive.\n");
+            goto Catch;
+        }
+        
+        /* Construct stencils */
+        GreenStencils = ConstructMosaicedStencils(Radius, COLOR_GREEN);
+        RedBlueStencils = ConstructMosaicedStencils(Radius, COLOR_RED);    
+        
+        /* Make sure that RedBlue axial stencils are the same as Green 
+           versions */
+        if(!StencilEquals(RedBlueStencils[0], GreenStencils[0])
+            || !StencilEquals(RedBlueStencils[2], GreenStencils[2]))
+        {
+            fprintf(stderr, "Assertion failed:\n"
+                "RedBlue axial stencils == Green axial stencils\n");
+            goto Catch;
+        }
+        
+        if((int)floor(Radius) > MaxRadius)
+            MaxRadius = (int)floor(Radius);
+        
+        /* AddPair appends to an existing key and returns its substitution.
+           Pointers from AddPair are only valid until the next call. */
+        Sub = AddPair(&Keys, &Subs, "KERNELS", "");
+        WritePixelTV(Sub, Radius, i, GreenStencils, RedBlueStencils);
+        WriteRowTV(Sub, Radius, i, GreenStencils, RedBlueStencils);
+        
+        AddPair(&Keys, &Subs, "RADII_LIST", (i == 0) ? "%g" : ", %g", 
+            Radius);
+        
+        /* Write the mstencilset entry with the stencil weights */
+        Sub = AddPair(&Keys, &Subs, "STENCIL_SETS", "");
+        AxialSum = StencilArcSum(GreenStencils[0]);
+        DiagonalSum = StencilArcSum(GreenStencils[1]); 
+        
+        StringAppend(Sub, "{%g, %d, PixelTV%d, RowTV%d,\n", 
+            Radius, (int)floor(Radius), i, i);
+        StringAppend(Sub, "    %.15e, %.15e,\n", 
+            1/AxialSum, 1/(AxialSum*WEIGHT_PI_8_FACTOR));
+        StringAppend(Sub, "    %.15e, %.15e,\n", 
+            AxialSum/DiagonalSum, 1/DiagonalSum);
+        
+        AxialSum = StencilArcSum(RedBlueStencils[0]);
+        DiagonalSum = StencilArcSum(RedBlueStencils[1]);
+        
+        StringAppend(Sub, "    %.15e, %.15e}%s", 
+            AxialSum/DiagonalSum, 1/DiagonalSum, 
+            (i < NumRadii - 1) ? ",\n" : "");
+        
+        FreeStencils(GreenStencils);
+        FreeStencils(RedBlueStencils);
+        GreenStencils = RedBlueStencils = NULL;
     }
     
-    /* Create the key-substitution pairs for the template */
-    AddPair(&Keys, &Subs, "RADIUS", "%d", (int)floor(Radius));
-    
-    AxialSum = StencilArcSum(GreenStencils[0]);
-    DiagonalSum = StencilArcSum(GreenStencils[1]); 
-    
-    Sub = AddPair(&Keys, &Subs, "AXIAL_TVS", "");
-    WriteTVComputation(Sub, GreenStencils, 0);
-    StringAppend(Sub, "\n");
-    WriteTVComputation(Sub, GreenStencils, 2);
-    
-    Sub = AddPair(&Keys, &Subs, "GREEN_DIAGONAL_TVS", "");
-    WriteTVComputation(Sub, GreenStencils, 1);
-    StringAppend(Sub, "\n");
-    WriteTVComputation(Sub, GreenStencils, 3);
-    
-    AddPair(&Keys, &Subs, 
-        "WEIGHT_AXIAL", "%.15e", 1/AxialSum);
-    AddPair(&Keys, &Subs, 
-        "WEIGHT_PI_8", "%.15e", 1/(AxialSum*WEIGHT_PI_8_FACTOR));
-    AddPair(&Keys, &Subs, 
-        "WEIGHT_GREEN_MU", "%.15e", AxialSum/DiagonalSum);
-    AddPair(&Keys, &Subs, 
-        "WEIGHT_GREEN_DIAGONAL", "%.15e", 1/DiagonalSum);
-            
-    AxialSum = StencilArcSum(RedBlueStencils[0]);
-    DiagonalSum = StencilArcSum(RedBlueStencils[1]);
-    
-    Sub = AddPair(&Keys, &Subs, "REDBLUE_DIAGONAL_TVS", "");
-    WriteTVComputation(Sub, RedBlueStencils, 1);
-    StringAppend(Sub, "\n");
-    WriteTVComputation(Sub, RedBlueStencils, 3);
-    
-    AddPair(&Keys, &Subs, 
-        "WEIGHT_REDBLUE_MU", "%.15e", AxialSum/DiagonalSum);
-    AddPair(&Keys, &Subs, 
-        "WEIGHT_REDBLUE_DIAGONAL", "%.15e", 1/DiagonalSum);
+    AddPair(&Keys, &Subs, "NUM_STENCIL_SETS", "%d", NumRadii);
+    AddPair(&Keys, &Subs, "MAX_RADIUS", "%d", MaxRadius);
     
     /* Fill the template */
-    FillTemplate(OutputFilename, TemplateFilename, Keys, Subs);
+    if(!FillTemplate(OutputFilename, TemplateFilename, Keys, Subs))
+        goto Catch;
     
     Status = 0;
 Catch:
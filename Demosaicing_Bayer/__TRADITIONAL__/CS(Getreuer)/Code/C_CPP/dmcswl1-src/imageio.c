@@ -693,9 +693,9 @@ static int ReadBmp(uint32_t **Image, int *Width, int *Height, FILE *File)
     }
     
     /* Check for problems or unsupported compression modes */
-    if(*Width > MAX_IMAGE_SIZE || *Height > MAX_IMAGE_SIZE)
+    if(IMAGE_SIZE_EXCEEDED(*Width, *Height))
     {
-        ErrorMessage("Image dimensions exceed MAX_IMAGE_SIZE.\n");
+        ErrorMessage("Image dimensions exceed MAX_IMAGE_SIZE or MAX_IMAGE_PIXELS.\n");
         goto Catch;
     }
     
@@ -1013,9 +1013,9 @@ static int ReadJpeg(uint32_t **Image, int *Width, int *Height, FILE *File)
     *Width = (int)cinfo.output_width;
     *Height = (int)cinfo.output_height;
     
-    if(*Width > MAX_IMAGE_SIZE || *Height > MAX_IMAGE_SIZE)
+    if(IMAGE_SIZE_EXCEEDED(*Width, *Height))
     {
-        ErrorMessage("Image dimensions exceed MAX_IMAGE_SIZE.\n");
+        ErrorMessage("Image dimensions exceed MAX_IMAGE_SIZE or MAX_IMAGE_PIXELS.\n");
         jpeg_abort_decompress(&cinfo);
         goto Catch;
     }
@@ -1191,6 +1191,12 @@ static int ReadPng(uint32_t **Image, int *Width, int *Height, FILE *File)
     *Width = (int)PngWidth;
     *Height = (int)PngHeight;
     
+    if(IMAGE_SIZE_EXCEEDED(*Width, *Height))
+    {
+        ErrorMessage("Image dimensions exceed MAX_IMAGE_SIZE or MAX_IMAGE_PIXELS.\n");
+        goto Catch;
+    }
+    
     /* Tell libpng to convert everything to 32-bit RGBA */
     if(ColorType == PNG_COLOR_TYPE_PALETTE)
         png_set_palette_to_rgb(Png);
@@ -1419,9 +1425,9 @@ static int ReadTiff(uint32_t **Image, int *Width, int *Height,
     *Width = (int)ImageWidth;
     *Height = (int)ImageHeight;
     
-    if(*Width > MAX_IMAGE_SIZE || *Height > MAX_IMAGE_SIZE)
+    if(IMAGE_SIZE_EXCEEDED(*Width, *Height))
     {
-        ErrorMessage("Image dimensions exceed MAX_IMAGE_SIZE.\n");
+        ErrorMessage("Image dimensions exceed MAX_IMAGE_SIZE or MAX_IMAGE_PIXELS.\n");
         goto Catch;
     }
     
@@ -20,7 +20,15 @@
 #include "basic.h"
 
 /** @brief Limit on the maximum allowed image width or height (security). */
-#define MAX_IMAGE_SIZE 10000
+#define MAX_IMAGE_SIZE 65535
+
+/** @brief Limit on the number of pixels, so that 4 Width Height fits in an int */
+#define MAX_IMAGE_PIXELS 536870911
+
+/** @brief Test whether image dimensions exceed the limits above */
+#define IMAGE_SIZE_EXCEEDED(Width, Height) ((Width) > MAX_IMAGE_SIZE    \
+    || (Height) > MAX_IMAGE_SIZE                                        \
+    || ((double)(Width))*((double)(Height)) > MAX_IMAGE_PIXELS)
 
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -15,10 +15,12 @@
 #ifndef _MSTENCILS_H_
 #define _MSTENCILS_H_
 
-void FitMosaicedStencils(int *Stencil, 
-    const float *Input, int Width, int Height, int RedX, int RedY);
+int FitMosaicedStencils(int *Stencil, const float *Input, 
+    int Width, int Height, int RedX, int RedY, float Radius);
+int IsMosaicedStencilRadius(float Radius);
+const char *MosaicedStencilRadii();
 
 int DisplayContours(const float *Image, int Width, int Height, 
-    int RedX, int RedY, const char *OutputFile);
+    int RedX, int RedY, float Radius, const char *OutputFile);
 
 #endif /* _MSTENCILS_H_ */
@@ -40,6 +40,15 @@ echo +==========================================================================
 
 .\imdiff frog.bmp frog-mal.bmp
 
+echo.
+echo.
+echo +============================================================================+
+echo + Finally, the fixed-point path on simulated 12-bit raw data is compared     +
+echo + with the float path                                                        +
+echo +============================================================================+
+
+.\dmmalvarcmp -b 12 frog.bmp
+
 echo.
 
 pause
@@ -13,36 +13,307 @@
  * not, see <http://www.opensource.org/licenses/bsd-license.html>.
  */
 
+#include "basic.h"
 #include "dmbilinear.h"
 
 
+/**
+ * @brief Flatten one row of a CFA-filtered image
+ * @param Flat output row
+ * @param Own input row of the non-green color that is present in this row
+ * @param Green input row of green
+ * @param Width the image width
+ * @param Col the column parity (0 or 1) of the non-green pixels in this row
+ */
+static ATTRIBUTE_ALWAYSINLINE void CfaFlattenRow(float *Flat, 
+    const float *Own, const float *Green, int Width, int Col)
+{
+    int x;
+    
+    
+    for(x = 0; x + 1 < Width; x += 2)
+    {
+        Flat[x + Col] = Own[x + Col];
+        Flat[x + 1 - Col] = Green[x + 1 - Col];
+    }
+    
+    if(x < Width)
+        Flat[x] = (Col) ? Green[x] : Own[x];
+}
+
+
+/**
+ * @brief CfaFlatten for a CFA phase known at compile time
+ * 
+ * This function is always inlined into CfaFlatten with constant RedX and
+ * RedY, so that each of the four instances has a fixed color layout.
+ */
+static ATTRIBUTE_ALWAYSINLINE void CfaFlattenPhase(float *Flat, 
+    const float *Input, int Width, int Height, int RedX, int RedY)
+{
+    const float *InputRed = Input;
+    const float *InputGreen = Input + Width*Height;
+    const float *InputBlue = Input + 2*Width*Height;
+    int i, y;
+
+    
+    for(y = 0, i = 0; y < Height; y++, i += Width)
+        if((y & 1) == RedY)
+            CfaFlattenRow(Flat + i, InputRed + i, InputGreen + i, 
+                Width, RedX);
+        else
+            CfaFlattenRow(Flat + i, InputBlue + i, InputGreen + i, 
+                Width, 1 - RedX);
+}
+
+
 /**
  * @brief Flatten a CFA-filtered image to a 2D array
  * @param Flat the output 2D array of size Width by Height
- * @param Input the input RGB image in planar row-major order
+ * @param Input the input RGB image in row-major planar order
  * @param Width, Height size of the image
  * @param RedX, RedY the coordinates of the upper-rightmost red pixel
  */
 void CfaFlatten(float *Flat, const float *Input, int Width, int Height, 
     int RedX, int RedY)
 {
-    const float *InputRed = Input;
-    const float *InputGreen = Input + Width*Height;
-    const float *InputBlue = Input + 2*Width*Height;
-    const int Green = 1 - ((RedX + RedY) & 1);
-    int i, x, y;
+    switch(CFA_PHASE(RedX, RedY))
+    {
+    case CFA_RGGB:
+        CfaFlattenPhase(Flat, Input, Width, Height, 0, 0);
+        break;
+    case CFA_GRBG:
+        CfaFlattenPhase(Flat, Input, Width, Height, 1, 0);
+        break;
+    case CFA_GBRG:
+        CfaFlattenPhase(Flat, Input, Width, Height, 0, 1);
+        break;
+    default:
+        CfaFlattenPhase(Flat, Input, Width, Height, 1, 1);
+        break;
+    }
+}
+
 
+/**
+ * @brief Bilinear (R-G) and (B-G) averages at one pixel with boundaries
+ * @param OutputRed, OutputGreen, OutputBlue the output channels
+ * @param Diff 2D array of (Red - Green) and (Blue - Green) differences
+ * @param Width, Height the image dimensions
+ * @param x, y, i the pixel coordinates and its index x + Width*y
+ * @param RedY the y-coordinate of the upper-rightmost red pixel
+ * @param Green the parity (x + y) & 1 of the green pixels
+ *
+ * This is the general form of the BilinearDifference interpolation, used
+ * on the 1-pixel image border.
+ */
+static void BilinearDifferencePixel(float *OutputRed, float *OutputGreen,
+    float *OutputBlue, const float *Diff, int Width, int Height, 
+    int x, int y, int i, int RedY, int Green)
+{
+    float AverageH, AverageV, AverageX;
+    
     
-    for(y = 0, i = 0; y < Height; y++)
-        for(x = 0; x < Width; x++, i++)
+    /* The following computes three quantities:
+     *   AverageH: average of the horizontal neighbors
+     *   AverageV: average of the vertical neighbors
+     *   AverageX: average of the diagonal neighbors
+     * 
+     * Near a boundary, the average is computed using only those 
+     * samples which are defined in the image.  For example on the left
+     * boundary of the image, the left neighbors are omitted and 
+     * AverageH is simply set to the value of the right neighbor.
+     */
+    if(y == 0)
+    {
+        AverageV = Diff[i + Width];
+        
+        if(x == 0)
         {
-            if(((x + y) & 1) == Green)
-                Flat[i] = InputGreen[i];
-            else if((y & 1) == RedY)
-                Flat[i] = InputRed[i];
-            else 
-                Flat[i] = InputBlue[i];
+            AverageH = Diff[i + 1];
+            AverageX = Diff[i + 1 + Width];
         }
+        else if(x < Width - 1)
+        {
+            AverageH = (Diff[i - 1] + Diff[i + 1]) / 2;
+            AverageX = (Diff[i - 1 + Width] + Diff[i + 1 + Width]) / 2;
+        }
+        else 
+        {
+            AverageH = Diff[i - 1];
+            AverageX = Diff[i - 1 + Width];
+        }
+        
+    }
+    else if(y < Height - 1)
+    {
+        AverageV = (Diff[i - Width] + Diff[i + Width]) / 2;
+        
+        if(x == 0)
+        {
+            AverageH = Diff[i + 1];
+            AverageX = (Diff[i + 1 - Width] + Diff[i + 1 + Width]) / 2;
+        }
+        else if(x < Width - 1)
+        {
+            AverageH = (Diff[i - 1] + Diff[i + 1]) / 2;
+            AverageX = (Diff[i - 1 - Width] + Diff[i + 1 - Width]
+                + Diff[i - 1 + Width] + Diff[i + 1 + Width]) / 4;
+        }
+        else 
+        {
+            AverageH = Diff[i - 1];
+            AverageX = (Diff[i - 1 - Width] + Diff[i - 1 + Width]) / 2;
+        }
+    }
+    else
+    {
+        AverageV = Diff[i - Width];
+        
+        if(x == 0)
+        {
+            AverageH = Diff[i + 1];
+            AverageX = Diff[i + 1 - Width];
+        }
+        else if(x < Width - 1)
+        {
+            AverageH = (Diff[i - 1] + Diff[i + 1]) / 2;
+            AverageX = (Diff[i - 1 - Width] + Diff[i + 1 - Width]) / 2;
+        }
+        else 
+        {
+            AverageH = Diff[i - 1];
+            AverageX = Diff[i - 1 - Width];
+        }
+    }
+
+    if(((x + y) & 1) == Green)
+    {
+        if((y & 1) == RedY)
+        {
+            /* Left and right neighbors are red */
+            OutputRed[i] = OutputGreen[i] + AverageH;
+            OutputBlue[i] = OutputGreen[i] + AverageV;
+        }
+        else
+        {
+            /* Left and right neighbors are blue */
+            OutputRed[i] = OutputGreen[i] + AverageV;
+            OutputBlue[i] = OutputGreen[i] + AverageH;
+        }
+    }
+    else
+    {
+        if((y & 1) == RedY)
+        {
+            /* Center pixel is red */
+            OutputRed[i] = OutputGreen[i] + Diff[i];
+            OutputBlue[i] = OutputGreen[i] + AverageX;
+        }
+        else
+        {
+            /* Center pixel is blue */
+            OutputRed[i] = OutputGreen[i] + AverageX;
+            OutputBlue[i] = OutputGreen[i] + Diff[i];
+        }
+    }
+}
+
+
+/**
+ * @brief Interior row of BilinearDifference
+ * @param Own output row of the non-green color that is present in this row
+ * @param Green output row of green, already filled
+ * @param Other output row of the non-green color absent from this row
+ * @param Diff row of the difference array
+ * @param Width the image width
+ * @param Col the column parity (0 or 1) of the non-green pixels in this row
+ *
+ * Computes columns 1 to Width - 2 of a row that is not the first or last
+ * row.  The loop is unrolled over the two pixels of a CFA period so that
+ * the color at each position is fixed and the body is branch-free.
+ */
+static ATTRIBUTE_ALWAYSINLINE void BilinearDifferenceRow(float *Own,
+    const float *Green, float *Other, const float *Diff, int Width, int Col)
+{
+    /* Within each unrolled pair starting at odd x, the red/blue pixel is at
+       offset Offset and the green pixel at offset 1 - Offset. */
+    const int Offset = 1 - Col;
+    const float *DiffUp = Diff - Width;
+    const float *DiffDown = Diff + Width;
+    int x, xRB, xG;
+    
+    
+    for(x = 1; x + 1 < Width - 1; x += 2)
+    {
+        xRB = x + Offset;
+        xG = x + 1 - Offset;
+        
+        Own[xRB] = Green[xRB] + Diff[xRB];
+        Other[xRB] = Green[xRB] + (DiffUp[xRB - 1] + DiffUp[xRB + 1]
+            + DiffDown[xRB - 1] + DiffDown[xRB + 1]) / 4;
+        Own[xG] = Green[xG] + (Diff[xG - 1] + Diff[xG + 1]) / 2;
+        Other[xG] = Green[xG] + (DiffUp[xG] + DiffDown[xG]) / 2;
+    }
+    
+    if(x < Width - 1)
+    {
+        if((x & 1) == Col)
+        {
+            Own[x] = Green[x] + Diff[x];
+            Other[x] = Green[x] + (DiffUp[x - 1] + DiffUp[x + 1]
+                + DiffDown[x - 1] + DiffDown[x + 1]) / 4;
+        }
+        else
+        {
+            Own[x] = Green[x] + (Diff[x - 1] + Diff[x + 1]) / 2;
+            Other[x] = Green[x] + (DiffUp[x] + DiffDown[x]) / 2;
+        }
+    }
+}
+
+
+/**
+ * @brief BilinearDifference for a CFA phase known at compile time
+ * 
+ * This function is always inlined into BilinearDifference with constant
+ * RedX and RedY, so that each of the four instances has a fixed color
+ * layout.
+ */
+static ATTRIBUTE_ALWAYSINLINE void BilinearDifferencePhase(float *Output,
+    const float *Diff, int Width, int Height, int RedX, int RedY)
+{
+    const int NumPixels = Width*Height;
+    const int Green = 1 - ((RedX + RedY) & 1);
+    float *OutputRed = Output;
+    float *OutputGreen = Output + NumPixels;
+    float *OutputBlue = Output + 2*NumPixels;
+    int x, y, i;
+    
+    
+    for(y = 0, i = 0; y < Height; y++, i += Width)
+    {
+        if(y == 0 || y == Height - 1 || Width < 3)
+        {
+            for(x = 0; x < Width; x++)
+                BilinearDifferencePixel(OutputRed, OutputGreen, OutputBlue,
+                    Diff, Width, Height, x, y, i + x, RedY, Green);
+            continue;
+        }
+        
+        BilinearDifferencePixel(OutputRed, OutputGreen, OutputBlue,
+            Diff, Width, Height, 0, y, i, RedY, Green);
+        
+        if((y & 1) == RedY)
+            BilinearDifferenceRow(OutputRed + i, OutputGreen + i, 
+                OutputBlue + i, Diff + i, Width, RedX);
+        else
+            BilinearDifferenceRow(OutputBlue + i, OutputGreen + i, 
+                OutputRed + i, Diff + i, Width, 1 - RedX);
+        
+        BilinearDifferencePixel(OutputRed, OutputGreen, OutputBlue,
+            Diff, Width, Height, Width - 1, y, i + Width - 1, RedY, Green);
+    }
 }
 
 
@@ -52,117 +323,298 @@ void CfaFlatten(float *Flat, const float *Input, int Width, int Height,
  * @param Diff 2D array of (Red - Green) and (Blue - Green) differences
  * @param Width, Height the image dimensions
  * @param RedX, RedY the coordinates of the upper-rightmost red pixel
+ * 
+ * This routine interpolates (R-G) and (B-G) differences using an already 
+ * filled green channel.  Output should be a contiguous array in row-major 
+ * planar order where the (second) green channel is filled.  The red and
+ * blue channels will be filled with the interpolation result.  The green
+ * channel is unchanged.  Diff is a 2D array in row-major order where the
+ * values denote (R-G) values at red locations at (B-G) values at blue 
+ * locations.
+ * 
+ * To interpolate (B-G) values at a red location, the (B-G) values of its four
+ * diagonal neighbors is averaged (the (B-G) values are known here because the
+ * the diagonal neighbors are all blue locations).  (R-G) values are 
+ * interpolated at blue locations similarly.
+ * 
+ * At a green location in a blue row, (B-G) is interpolated by averaging the 
+ * (B-G) values of its horizontal neighbors, which are both blue locations.
+ * (R-G) is interpolated by averaging its vertical neighbors.  Interpolation
+ * at a green location in a red row is similar.
+ * 
+ * The 1-pixel image border is handled with the general boundary formulas
+ * and the interior with a branch-free kernel, which gives the same result.
  */
 void BilinearDifference(float *Output, const float *Diff,
     int Width, int Height, int RedX, int RedY)
 {
-    const int NumPixels = Width*Height;
-    const int Green = 1 - ((RedX + RedY) & 1);
-    float *OutputRed = Output;
-    float *OutputGreen = Output + NumPixels;
-    float *OutputBlue = Output + 2*NumPixels;
-    float AverageH, AverageV, AverageX;
-    int x, y, i;
+    switch(CFA_PHASE(RedX, RedY))
+    {
+    case CFA_RGGB:
+        BilinearDifferencePhase(Output, Diff, Width, Height, 0, 0);
+        break;
+    case CFA_GRBG:
+        BilinearDifferencePhase(Output, Diff, Width, Height, 1, 0);
+        break;
+    case CFA_GBRG:
+        BilinearDifferencePhase(Output, Diff, Width, Height, 0, 1);
+        break;
+    default:
+        BilinearDifferencePhase(Output, Diff, Width, Height, 1, 1);
+        break;
+    }
+}
+
+
+/**
+ * @brief Bilinear demosaicing at one pixel with boundary handling
+ * @param OutputRed, OutputGreen, OutputBlue the output channels
+ * @param Input the input image as a flattened 2D array
+ * @param Width, Height the image dimensions
+ * @param x, y, i the pixel coordinates and its index x + Width*y
+ * @param RedY the y-coordinate of the upper-rightmost red pixel
+ * @param Green the parity (x + y) & 1 of the green pixels
+ *
+ * This is the general form of the BilinearDemosaic interpolation, used on 
+ * the 1-pixel image border.
+ */
+static void BilinearDemosaicPixel(float *OutputRed, float *OutputGreen,
+    float *OutputBlue, const float *Input, int Width, int Height, 
+    int x, int y, int i, int RedY, int Green)
+{
+    float AverageH, AverageV, AverageC, AverageX;
+    
+    
+    /* The following computes four quantities:
+     *   AverageH: average of the horizontal neighbors
+     *   AverageV: average of the vertical neighbors
+     *   AverageC: average of the axial neighbors
+     *   AverageX: average of the diagonal neighbors
+     * 
+     * Near a boundary, the average is computed using only those 
+     * samples which are defined in the image.  For example on the left
+     * boundary of the image, the left neighbors are omitted and 
+     * AverageH is simply set to the value of the right neighbor.
+     */
+    if(y == 0)
+    {
+        AverageV = Input[i + Width];
+        
+        if(x == 0)
+        {
+            AverageH = Input[i + 1];
+            AverageC = (Input[i + 1] + Input[i + Width])/2;
+            AverageX = Input[i + 1 + Width];
+        }
+        else if(x < Width - 1)
+        {
+            AverageH = (Input[i - 1] + Input[i + 1]) / 2;
+            AverageC = (Input[i - 1] + Input[i + 1] 
+                + Input[i + Width])/3;
+            AverageX = (Input[i - 1 + Width] 
+                + Input[i + 1 + Width]) / 2;
+        }
+        else 
+        {
+            AverageH = Input[i - 1];
+            AverageC = (Input[i - 1] + Input[i + Width])/2;
+            AverageX = Input[i - 1 + Width];
+        }
+    }
+    else if(y < Height - 1)
+    {
+        AverageV = (Input[i - Width] + Input[i + Width]) / 2;
+        
+        if(x == 0)
+        {
+            AverageH = Input[i + 1];
+            AverageC = (Input[i + 1] + 
+                Input[i - Width] + Input[i + Width]) / 3;
+            AverageX = (Input[i + 1 - Width] 
+                + Input[i + 1 + Width]) / 2;
+        }
+        else if(x < Width - 1)
+        {
+            AverageH = (Input[i - 1] + Input[i + 1]) / 2;
+            AverageC = (AverageH + AverageV) / 2;
+            AverageX = (Input[i - 1 - Width] + Input[i + 1 - Width]
+                + Input[i - 1 + Width] + Input[i + 1 + Width]) / 4;
+        }
+        else 
+        {
+            AverageH = Input[i - 1];
+            AverageC = (Input[i - 1] + 
+                Input[i - Width] + Input[i + Width]) / 3;
+            AverageX = (Input[i - 1 - Width] 
+                + Input[i - 1 + Width]) / 2;
+        }
+    }
+    else
+    {
+        AverageV = Input[i - Width];
+        
+        if(x == 0)
+        {
+            AverageH = Input[i + 1];
+            AverageC = (Input[i + 1] + Input[i - Width]) / 2;
+            AverageX = Input[i + 1 - Width];
+        }
+        else if(x < Width - 1)
+        {
+            AverageH = (Input[i - 1] + Input[i + 1]) / 2;
+            AverageC = (Input[i - 1] 
+                + Input[i + 1] + Input[i - Width]) / 3;
+            AverageX = (Input[i - 1 - Width] 
+                + Input[i + 1 - Width]) / 2;
+        }
+        else 
+        {
+            AverageH = Input[i - 1];
+            AverageC = (Input[i - 1] + Input[i - Width]) / 2;
+            AverageX = Input[i - 1 - Width];
+        }
+    }
+    
+    if(((x + y) & 1) == Green)
+    {
+        /* Center pixel is green */
+        OutputGreen[i] = Input[i];
+        
+        if((y & 1) == RedY)
+        {
+            /* Left and right neighbors are red */
+            OutputRed[i] = AverageH;
+            OutputBlue[i] = AverageV;
+        }
+        else
+        {
+            /* Left and right neighbors are blue */
+            OutputRed[i] = AverageV;
+            OutputBlue[i] = AverageH;
+        }
+    }
+    else
+    {
+        OutputGreen[i] = AverageC;
+        
+        if((y & 1) == RedY)
+        {
+            /* Center pixel is red */
+            OutputRed[i] = Input[i];
+            OutputBlue[i] = AverageX;
+        }
+        else
+        {
+            /* Center pixel is blue */
+            OutputRed[i] = AverageX;
+            OutputBlue[i] = Input[i];
+        }
+    }
+}
+
+
+/**
+ * @brief Interior row of BilinearDemosaic
+ * @param Own output row of the non-green color that is present in this row
+ * @param Green output row of green
+ * @param Other output row of the non-green color absent from this row
+ * @param Input row of the input image
+ * @param Width the image width
+ * @param Col the column parity (0 or 1) of the non-green pixels in this row
+ *
+ * Computes columns 1 to Width - 2 of a row that is not the first or last
+ * row.  The loop is unrolled over the two pixels of a CFA period so that
+ * the color at each position is fixed and the body is branch-free.
+ */
+static ATTRIBUTE_ALWAYSINLINE void BilinearDemosaicRow(float *Own,
+    float *Green, float *Other, const float *Input, int Width, int Col)
+{
+    /* Within each unrolled pair starting at odd x, the red/blue pixel is at
+       offset Offset and the green pixel at offset 1 - Offset. */
+    const int Offset = 1 - Col;
+    const float *InputUp = Input - Width;
+    const float *InputDown = Input + Width;
+    float AverageH, AverageV;
+    int x, xRB, xG;
     
     
-    for(y = 0, i = 0; y < Height; y++)
+    for(x = 1; x + 1 < Width - 1; x += 2)
+    {
+        xRB = x + Offset;
+        xG = x + 1 - Offset;
+        
+        AverageH = (Input[xRB - 1] + Input[xRB + 1]) / 2;
+        AverageV = (InputUp[xRB] + InputDown[xRB]) / 2;
+        Own[xRB] = Input[xRB];
+        Green[xRB] = (AverageH + AverageV) / 2;
+        Other[xRB] = (InputUp[xRB - 1] + InputUp[xRB + 1]
+            + InputDown[xRB - 1] + InputDown[xRB + 1]) / 4;
+        
+        Green[xG] = Input[xG];
+        Own[xG] = (Input[xG - 1] + Input[xG + 1]) / 2;
+        Other[xG] = (InputUp[xG] + InputDown[xG]) / 2;
+    }
+    
+    if(x < Width - 1)
     {
-        for(x = 0; x < Width; x++, i++)
-        {
-            if(y == 0)
-            {
-                AverageV = Diff[i + Width];
-                
-                if(x == 0)
-                {
-                    AverageH = Diff[i + 1];
-                    AverageX = Diff[i + 1 + Width];
-                }
-                else if(x < Width - 1)
-                {
-                    AverageH = (Diff[i - 1] + Diff[i + 1]) / 2;
-                    AverageX = (Diff[i - 1 + Width] + Diff[i + 1 + Width]) / 2;
-                }
-                else 
-                {
-                    AverageH = Diff[i - 1];
-                    AverageX = Diff[i - 1 + Width];
-                }
-                
-            }
-            else if(y < Height - 1)
-            {
-                AverageV = (Diff[i - Width] + Diff[i + Width]) / 2;
-                
-                if(x == 0)
-                {
-                    AverageH = Diff[i + 1];
-                    AverageX = (Diff[i + 1 - Width] + Diff[i + 1 + Width]) / 2;
-                }
-                else if(x < Width - 1)
-                {
-                    AverageH = (Diff[i - 1] + Diff[i + 1]) / 2;
-                    AverageX = (Diff[i - 1 - Width] + Diff[i + 1 - Width]
-                        + Diff[i - 1 + Width] + Diff[i + 1 + Width]) / 4;
-                }
-                else 
-                {
-                    AverageH = Diff[i - 1];
-                    AverageX = (Diff[i - 1 - Width] + Diff[i - 1 + Width]) / 2;
-                }
-            }
-            else
-            {
-                AverageV = Diff[i - Width];
-                
-                if(x == 0)
-                {
-                    AverageH = Diff[i + 1];
-                    AverageX = Diff[i + 1 - Width];
-                }
-                else if(x < Width - 1)
-                {
-                    AverageH = (Diff[i - 1] + Diff[i + 1]) / 2;
-                    AverageX = (Diff[i - 1 - Width] + Diff[i + 1 - Width]) / 2;
-                }
-                else 
-                {
-                    AverageH = Diff[i - 1];
-                    AverageX = Diff[i - 1 - Width];
-                }
-            }
+        AverageH = (Input[x - 1] + Input[x + 1]) / 2;
+        AverageV = (InputUp[x] + InputDown[x]) / 2;
+        
+        if((x & 1) == Col)
+        {
+            Own[x] = Input[x];
+            Green[x] = (AverageH + AverageV) / 2;
+            Other[x] = (InputUp[x - 1] + InputUp[x + 1]
+                + InputDown[x - 1] + InputDown[x + 1]) / 4;
+        }
+        else
+        {
+            Green[x] = Input[x];
+            Own[x] = AverageH;
+            Other[x] = AverageV;
+        }
+    }
+}
 
-            if(((x + y) & 1) == Green)
-            {
-                if((y & 1) == RedY)
-                {
-                    /* Left and right neighbors are red */
-                    OutputRed[i] = OutputGreen[i] + AverageH;
-                    OutputBlue[i] = OutputGreen[i] + AverageV;
-                }
-                else
-                {
-                    /* Left and right neighbors are blue */
-                    OutputRed[i] = OutputGreen[i] + AverageV;
-                    OutputBlue[i] = OutputGreen[i] + AverageH;
-                }
-            }
-            else
-            {
-                if((y & 1) == RedY)
-                {
-                    /* Center pixel is red */
-                    OutputRed[i] = OutputGreen[i] + Diff[i];
-                    OutputBlue[i] = OutputGreen[i] + AverageX;
-                }
-                else
-                {
-                    /* Center pixel is blue */
-                    OutputRed[i] = OutputGreen[i] + AverageX;
-                    OutputBlue[i] = OutputGreen[i] + Diff[i];
-                }
-            }            
+
+/**
+ * @brief BilinearDemosaic for a CFA phase known at compile time
+ * 
+ * This function is always inlined into BilinearDemosaic with constant RedX
+ * and RedY, so that each of the four instances has a fixed color layout.
+ */
+static ATTRIBUTE_ALWAYSINLINE void BilinearDemosaicPhase(float *Output,
+    const float *Input, int Width, int Height, int RedX, int RedY)
+{
+    float *OutputRed = Output;
+    float *OutputGreen = Output + Width*Height;
+    float *OutputBlue = Output + 2*Width*Height;
+    const int Green = 1 - ((RedX + RedY) & 1);
+    int i, x, y;
+        
+
+    for(y = 0, i = 0; y < Height; y++, i += Width)
+    {
+        if(y == 0 || y == Height - 1 || Width < 3)
+        {
+            for(x = 0; x < Width; x++)
+                BilinearDemosaicPixel(OutputRed, OutputGreen, OutputBlue,
+                    Input, Width, Height, x, y, i + x, RedY, Green);
+            continue;
         }
+        
+        BilinearDemosaicPixel(OutputRed, OutputGreen, OutputBlue,
+            Input, Width, Height, 0, y, i, RedY, Green);
+        
+        if((y & 1) == RedY)
+            BilinearDemosaicRow(OutputRed + i, OutputGreen + i, 
+                OutputBlue + i, Input + i, Width, RedX);
+        else
+            BilinearDemosaicRow(OutputBlue + i, OutputGreen + i, 
+                OutputRed + i, Input + i, Width, 1 - RedX);
+        
+        BilinearDemosaicPixel(OutputRed, OutputGreen, OutputBlue,
+            Input, Width, Height, Width - 1, y, i + Width - 1, RedY, Green);
     }
 }
 
@@ -180,136 +632,26 @@ void BilinearDifference(float *Output, const float *Diff,
  * The Input image is a 2D float array of the input RGB values of size 
  * Width*Height in row-major order.  RedX, RedY are the coordinates of the 
  * upper-rightmost red pixel to specify the CFA pattern.
+ *
+ * The 1-pixel image border is handled with the general boundary formulas
+ * and the interior with a branch-free kernel, which gives the same result.
  */
 void BilinearDemosaic(float *Output, const float *Input, int Width, int Height, 
     int RedX, int RedY)
 {
-    float *OutputRed = Output;
-    float *OutputGreen = Output + Width*Height;
-    float *OutputBlue = Output + 2*Width*Height;
-    const int Green = 1 - ((RedX + RedY) & 1);
-    float AverageH, AverageV, AverageC, AverageX;
-    int i, x, y;
-        
-
-    for(y = 0, i = 0; y < Height; y++)
+    switch(CFA_PHASE(RedX, RedY))
     {
-        for(x = 0; x < Width; x++, i++)
-        {
-            if(y == 0)
-            {
-                AverageV = Input[i + Width];
-                
-                if(x == 0)
-                {
-                    AverageH = Input[i + 1];
-                    AverageC = (Input[i + 1] + Input[i + Width])/2;
-                    AverageX = Input[i + 1 + Width];
-                }
-                else if(x < Width - 1)
-                {
-                    AverageH = (Input[i - 1] + Input[i + 1]) / 2;
-                    AverageC = (Input[i - 1] + Input[i + 1] 
-                        + Input[i + Width])/3;
-                    AverageX = (Input[i - 1 + Width] 
-                        + Input[i + 1 + Width]) / 2;
-                }
-                else 
-                {
-                    AverageH = Input[i - 1];
-                    AverageC = (Input[i - 1] + Input[i + Width])/2;
-                    AverageX = Input[i - 1 + Width];
-                }
-            }
-            else if(y < Height - 1)
-            {
-                AverageV = (Input[i - Width] + Input[i + Width]) / 2;
-                
-                if(x == 0)
-                {
-                    AverageH = Input[i + 1];
-                    AverageC = (Input[i + 1] + 
-                        Input[i - Width] + Input[i + Width]) / 3;
-                    AverageX = (Input[i + 1 - Width] 
-                        + Input[i + 1 + Width]) / 2;
-                }
-                else if(x < Width - 1)
-                {
-                    AverageH = (Input[i - 1] + Input[i + 1]) / 2;
-                    AverageC = (AverageH + AverageV) / 2;
-                    AverageX = (Input[i - 1 - Width] + Input[i + 1 - Width]
-                        + Input[i - 1 + Width] + Input[i + 1 + Width]) / 4;
-                }
-                else 
-                {
-                    AverageH = Input[i - 1];
-                    AverageC = (Input[i - 1] + 
-                        Input[i - Width] + Input[i + Width]) / 3;
-                    AverageX = (Input[i - 1 - Width] 
-                        + Input[i - 1 + Width]) / 2;
-                }
-            }
-            else
-            {
-                AverageV = Input[i - Width];
-                
-                if(x == 0)
-                {
-                    AverageH = Input[i + 1];
-                    AverageC = (Input[i + 1] + Input[i - Width]) / 2;
-                    AverageX = Input[i + 1 - Width];
-                }
-                else if(x < Width - 1)
-                {
-                    AverageH = (Input[i - 1] + Input[i + 1]) / 2;
-                    AverageC = (Input[i - 1] 
-                        + Input[i + 1] + Input[i - Width]) / 3;
-                    AverageX = (Input[i - 1 - Width] 
-                        + Input[i + 1 - Width]) / 2;
-                }
-                else 
-                {
-                    AverageH = Input[i - 1];
-                    AverageC = (Input[i - 1] + Input[i - Width]) / 2;
-                    AverageX = Input[i - 1 - Width];
-                }
-            }
-            
-            if(((x + y) & 1) == Green)
-            {
-                /* Center pixel is green */
-                OutputGreen[i] = Input[i];
-                
-                if((y & 1) == RedY)
-                {
-                    /* Left and right neighbors are red */
-                    OutputRed[i] = AverageH;
-                    OutputBlue[i] = AverageV;
-                }
-                else
-                {
-                    /* Left and right neighbors are blue */
-                    OutputRed[i] = AverageV;
-                    OutputBlue[i] = AverageH;
-                }
-            }
-            else
-            {
-                OutputGreen[i] = AverageC;
-                
-                if((y & 1) == RedY)
-                {
-                    /* Center pixel is red */
-                    OutputRed[i] = Input[i];
-                    OutputBlue[i] = AverageX;
-                }
-                else
-                {
-                    /* Center pixel is blue */
-                    OutputRed[i] = AverageX;
-                    OutputBlue[i] = Input[i];
-                }
-            }
-        }
+    case CFA_RGGB:
+        BilinearDemosaicPhase(Output, Input, Width, Height, 0, 0);
+        break;
+    case CFA_GRBG:
+        BilinearDemosaicPhase(Output, Input, Width, Height, 1, 0);
+        break;
+    case CFA_GBRG:
+        BilinearDemosaicPhase(Output, Input, Width, Height, 0, 1);
+        break;
+    default:
+        BilinearDemosaicPhase(Output, Input, Width, Height, 1, 1);
+        break;
     }
 }
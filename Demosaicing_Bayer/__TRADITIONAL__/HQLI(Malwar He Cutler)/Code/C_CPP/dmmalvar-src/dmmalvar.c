@@ -31,6 +31,424 @@
  */
 
 
+#include <string.h>
+#include "basic.h"
+#include "dmbilinear.h"
+#include "dmmalvar.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+/** @brief Interior kernel uses 8-lane AVX vectors */
+#define MALVAR_VECTOR_AVX
+#elif defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+/** @brief Interior kernel uses 4-lane SSE2 vectors */
+#define MALVAR_VECTOR_SSE2
+#endif
+
+
+/* 
+ * The following macros evaluate the Malvar-He-Cutler filters at an interior
+ * pixel, where every tap of the 5x5 neighborhood is present.  Row[0],...,
+ * Row[4] point to rows y-2,...,y+2 of the input.  The *_NUM macros compute
+ * the filter numerators and work for both float and integer input, the 
+ * denominators are 8 for MALVAR_G_AT_RB and 16 for the others.  The
+ * arithmetic is written in exactly the same order as in MalvarBorderPixel
+ * so that the float interior result is bit-identical to evaluating the 
+ * general boundary formulas with all presences equal to one.
+ */
+
+/** @brief Green at a red or blue pixel, times 8 */
+#define MALVAR_G_AT_RB_NUM(Row, x) \
+    (2*(Row[1][x] + Row[2][(x) - 1] + Row[2][(x) + 1] + Row[3][x]) \
+    + 4*Row[2][x] - Row[2][(x) - 2] - Row[2][(x) + 2] \
+    - Row[0][x] - Row[4][x])
+
+/** @brief Red at a blue pixel or blue at a red pixel, times 16 */
+#define MALVAR_RB_AT_BR_NUM(Row, x) \
+    (4*(Row[1][(x) - 1] + Row[1][(x) + 1] \
+    + Row[3][(x) - 1] + Row[3][(x) + 1]) \
+    + 3*(4*Row[2][x] - Row[2][(x) - 2] - Row[2][(x) + 2] \
+    - Row[0][x] - Row[4][x]))
+
+/** @brief Red or blue at a green pixel from horizontal neighbors, times 16 */
+#define MALVAR_RB_AT_G_H_NUM(Row, x) \
+    (8*(Row[2][(x) - 1] + Row[2][(x) + 1]) + 10*Row[2][x] \
+    - 2*(Row[1][(x) - 1] + Row[1][(x) + 1] \
+    + Row[2][(x) - 2] + Row[2][(x) + 2] \
+    + Row[3][(x) - 1] + Row[3][(x) + 1]) \
+    + Row[0][x] + Row[4][x])
+
+/** @brief Red or blue at a green pixel from vertical neighbors, times 16 */
+#define MALVAR_RB_AT_G_V_NUM(Row, x) \
+    (8*(Row[1][x] + Row[3][x]) + 10*Row[2][x] \
+    - 2*(Row[1][(x) - 1] + Row[1][(x) + 1] \
+    + Row[0][x] + Row[4][x] \
+    + Row[3][(x) - 1] + Row[3][(x) + 1]) \
+    + Row[2][(x) - 2] + Row[2][(x) + 2])
+
+/** @brief Green at a red or blue pixel */
+#define MALVAR_G_AT_RB(Row, x)      (MALVAR_G_AT_RB_NUM(Row, x) / 8)
+/** @brief Red at a blue pixel or blue at a red pixel */
+#define MALVAR_RB_AT_BR(Row, x)     (MALVAR_RB_AT_BR_NUM(Row, x) / 16)
+/** @brief Red or blue at a green pixel from its horizontal neighbors */
+#define MALVAR_RB_AT_G_H(Row, x)    (MALVAR_RB_AT_G_H_NUM(Row, x) / 16)
+/** @brief Red or blue at a green pixel from its vertical neighbors */
+#define MALVAR_RB_AT_G_V(Row, x)    (MALVAR_RB_AT_G_V_NUM(Row, x) / 16)
+
+
+/**
+ * @brief Malvar-He-Cutler demosaicing at one pixel with boundary handling
+ * @param OutputRed, OutputGreen, OutputBlue output rows for row y
+ * @param Row pointers to input rows y-2,...,y+2, NULL if outside the image
+ * @param Width the image width
+ * @param x the column to compute
+ * @param y the row to compute
+ * @param RedX, RedY the coordinates of the upper-rightmost red pixel
+ *
+ * Neighbors beyond the image boundaries are treated as absent and the
+ * filter normalization is adjusted accordingly.  This is the general 
+ * formulation of the method and is used for the 2-pixel border.
+ */
+static void MalvarBorderPixel(float *OutputRed, float *OutputGreen, 
+    float *OutputBlue, const float *Row[5], int Width, int x, int y,
+    int RedX, int RedY)
+{
+    const int BlueX = 1 - RedX;
+    const int BlueY = 1 - RedY;
+    /* Neigh holds a copy of the 5x5 neighborhood around the current point */
+    float Neigh[5][5];
+    /* NeighPresence is used for boundary handling.  It is set to 0 if the 
+       neighbor is beyond the boundaries of the image and 1 otherwise. */
+    int NeighPresence[5][5];
+    int nx, ny;
+    
+    
+    /* 5x5 neighborhood around the point (x,y) is copied into Neigh */
+    for(ny = -2; ny <= 2; ny++)
+    {
+        for(nx = -2; nx <= 2; nx++)
+        {
+            if(0 <= x + nx && x + nx < Width && Row[2 + ny])
+            {
+                Neigh[2 + nx][2 + ny] = Row[2 + ny][x + nx];
+                NeighPresence[2 + nx][2 + ny] = 1;
+            }
+            else
+            {
+                Neigh[2 + nx][2 + ny] = 0;
+                NeighPresence[2 + nx][2 + ny] = 0;
+            }
+        }
+    }
+
+    if((x & 1) == RedX && (y & 1) == RedY)
+    {
+        /* Center pixel is red */
+        OutputRed[x] = Row[2][x];
+        OutputGreen[x] = (2*(Neigh[2][1] + Neigh[1][2]
+            + Neigh[3][2] + Neigh[2][3])
+            + (NeighPresence[0][2] + NeighPresence[4][2]
+            + NeighPresence[2][0] + NeighPresence[2][4])*Neigh[2][2] 
+            - Neigh[0][2] - Neigh[4][2]
+            - Neigh[2][0] - Neigh[2][4])
+            / (2*(NeighPresence[2][1] + NeighPresence[1][2]
+            + NeighPresence[3][2] + NeighPresence[2][3]));
+        OutputBlue[x] = (4*(Neigh[1][1] + Neigh[3][1]
+            + Neigh[1][3] + Neigh[3][3]) +
+            3*((NeighPresence[0][2] + NeighPresence[4][2]
+            + NeighPresence[2][0] + NeighPresence[2][4])*Neigh[2][2] 
+            - Neigh[0][2] - Neigh[4][2]
+            - Neigh[2][0] - Neigh[2][4])) 
+            / (4*(NeighPresence[1][1] + NeighPresence[3][1]
+            + NeighPresence[1][3] + NeighPresence[3][3]));
+    }
+    else if((x & 1) == BlueX && (y & 1) == BlueY)
+    {
+        /* Center pixel is blue */
+        OutputBlue[x] = Row[2][x];
+        OutputGreen[x] = (2*(Neigh[2][1] + Neigh[1][2]
+            + Neigh[3][2] + Neigh[2][3])
+            + (NeighPresence[0][2] + NeighPresence[4][2]
+            + NeighPresence[2][0] + NeighPresence[2][4])*Neigh[2][2] 
+            - Neigh[0][2] - Neigh[4][2]
+            - Neigh[2][0] - Neigh[2][4])
+            / (2*(NeighPresence[2][1] + NeighPresence[1][2]
+            + NeighPresence[3][2] + NeighPresence[2][3]));
+        OutputRed[x] = (4*(Neigh[1][1] + Neigh[3][1]
+            + Neigh[1][3] + Neigh[3][3]) +
+            3*((NeighPresence[0][2] + NeighPresence[4][2]
+            + NeighPresence[2][0] + NeighPresence[2][4])*Neigh[2][2] 
+            - Neigh[0][2] - Neigh[4][2]
+            - Neigh[2][0] - Neigh[2][4])) 
+            / (4*(NeighPresence[1][1] + NeighPresence[3][1]
+            + NeighPresence[1][3] + NeighPresence[3][3]));
+    }
+    else
+    {
+        /* Center pixel is green */
+        OutputGreen[x] = Row[2][x];
+        
+        if((y & 1) == RedY)
+        {
+            /* Left and right neighbors are red */
+            OutputRed[x] = (8*(Neigh[1][2] + Neigh[3][2])
+                + (2*(NeighPresence[1][1] + NeighPresence[3][1]
+                + NeighPresence[0][2] + NeighPresence[4][2]
+                + NeighPresence[1][3] + NeighPresence[3][3])
+                - NeighPresence[2][0] - NeighPresence[2][4])*Neigh[2][2]
+                - 2*(Neigh[1][1] + Neigh[3][1]
+                + Neigh[0][2] + Neigh[4][2]
+                + Neigh[1][3] + Neigh[3][3])
+                + Neigh[2][0] + Neigh[2][4]) 
+                / (8*(NeighPresence[1][2] + NeighPresence[3][2]));
+            OutputBlue[x] = (8*(Neigh[2][1] + Neigh[2][3])
+                + (2*(NeighPresence[1][1] + NeighPresence[3][1]
+                + NeighPresence[2][0] + NeighPresence[2][4]
+                + NeighPresence[1][3] + NeighPresence[3][3])
+                - NeighPresence[0][2] - NeighPresence[4][2])*Neigh[2][2]
+                - 2*(Neigh[1][1] + Neigh[3][1]
+                + Neigh[2][0] + Neigh[2][4]
+                + Neigh[1][3] + Neigh[3][3])
+                + Neigh[0][2] + Neigh[4][2]) 
+                / (8*(NeighPresence[2][1] + NeighPresence[2][3]));
+        }
+        else
+        {
+            /* Left and right neighbors are blue */
+            OutputRed[x] = (8*(Neigh[2][1] + Neigh[2][3])
+                + (2*(NeighPresence[1][1] + NeighPresence[3][1]
+                + NeighPresence[2][0] + NeighPresence[2][4]
+                + NeighPresence[1][3] + NeighPresence[3][3])
+                - NeighPresence[0][2] - NeighPresence[4][2])*Neigh[2][2]
+                - 2*(Neigh[1][1] + Neigh[3][1]
+                + Neigh[2][0] + Neigh[2][4]
+                + Neigh[1][3] + Neigh[3][3])
+                + Neigh[0][2] + Neigh[4][2]) 
+                / (8*(NeighPresence[2][1] + NeighPresence[2][3]));
+            OutputBlue[x] = (8*(Neigh[1][2] + Neigh[3][2])
+                + (2*(NeighPresence[1][1] + NeighPresence[3][1]
+                + NeighPresence[0][2] + NeighPresence[4][2]
+                + NeighPresence[1][3] + NeighPresence[3][3])
+                - NeighPresence[2][0] - NeighPresence[2][4])*Neigh[2][2]
+                - 2*(Neigh[1][1] + Neigh[3][1]
+                + Neigh[0][2] + Neigh[4][2]
+                + Neigh[1][3] + Neigh[3][3])
+                + Neigh[2][0] + Neigh[2][4]) 
+                / (8*(NeighPresence[1][2] + NeighPresence[3][2]));
+        }
+    }
+}
+
+
+#if defined(MALVAR_VECTOR_AVX) || defined(MALVAR_VECTOR_SSE2)
+
+#ifdef MALVAR_VECTOR_AVX
+typedef __m256 vfloat;
+#define VLANES                  8
+#define VLOAD(p)                _mm256_loadu_ps(p)
+#define VSTORE(p, a)            _mm256_storeu_ps(p, a)
+#define VSET1(c)                _mm256_set1_ps(c)
+#define VADD(a, b)              _mm256_add_ps(a, b)
+#define VSUB(a, b)              _mm256_sub_ps(a, b)
+#define VMUL(a, b)              _mm256_mul_ps(a, b)
+#define VSELECT(m, a, b)        _mm256_blendv_ps(b, a, m)
+#define VMASK_EVEN  _mm256_castsi256_ps(_mm256_set_epi32(0,-1,0,-1,0,-1,0,-1))
+#define VMASK_ODD   _mm256_castsi256_ps(_mm256_set_epi32(-1,0,-1,0,-1,0,-1,0))
+#else
+typedef __m128 vfloat;
+#define VLANES                  4
+#define VLOAD(p)                _mm_loadu_ps(p)
+#define VSTORE(p, a)            _mm_storeu_ps(p, a)
+#define VSET1(c)                _mm_set1_ps(c)
+#define VADD(a, b)              _mm_add_ps(a, b)
+#define VSUB(a, b)              _mm_sub_ps(a, b)
+#define VMUL(a, b)              _mm_mul_ps(a, b)
+#define VSELECT(m, a, b)        _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#define VMASK_EVEN  _mm_castsi128_ps(_mm_set_epi32(0,-1,0,-1))
+#define VMASK_ODD   _mm_castsi128_ps(_mm_set_epi32(-1,0,-1,0))
+#endif
+
+/**
+ * @brief Vectorized interior kernel for one row
+ * @param Own output row of the non-green color that is present in this row
+ * @param Green output row of green
+ * @param Other output row of the non-green color absent from this row
+ * @param Row pointers to input rows y-2,...,y+2
+ * @param x the first column to compute, must be even
+ * @param xEnd one past the last column that may be computed
+ * @param Col the column parity (0 or 1) of the non-green pixels in this row
+ * @return the first column that was not computed
+ *
+ * Each vector covers VLANES/2 consecutive 2x2 Bayer quads of the row.  All
+ * four filters are evaluated in every lane and the results are selected by
+ * CFA parity, so the kernel has no branches.  Divisions by 8 and 16 are
+ * done as multiplications by 1/8 and 1/16, which is exact in floating 
+ * point.
+ */
+static ATTRIBUTE_ALWAYSINLINE int MalvarInteriorRowVector(float *Own,
+    float *Green, float *Other, const float *Row[5], int x, int xEnd, int Col)
+{
+    const vfloat Two = VSET1(2.0f), Three = VSET1(3.0f), Four = VSET1(4.0f);
+    const vfloat Eight = VSET1(8.0f), Ten = VSET1(10.0f);
+    const vfloat OneEighth = VSET1(0.125f), OneSixteenth = VSET1(0.0625f);
+    const vfloat Mask = (Col) ? VMASK_ODD : VMASK_EVEN;
+    vfloat Center, Left, Right, Left2, Right2, Up, Down, Up2, Down2;
+    vfloat UpLeft, UpRight, DownLeft, DownRight, Laplacian;
+    vfloat GreenAtRB, RBAtBR, RBAtGH, RBAtGV;
+    
+    
+    for(; x + VLANES <= xEnd; x += VLANES)
+    {
+        Center = VLOAD(Row[2] + x);
+        Left = VLOAD(Row[2] + x - 1);
+        Right = VLOAD(Row[2] + x + 1);
+        Left2 = VLOAD(Row[2] + x - 2);
+        Right2 = VLOAD(Row[2] + x + 2);
+        Up = VLOAD(Row[1] + x);
+        Down = VLOAD(Row[3] + x);
+        Up2 = VLOAD(Row[0] + x);
+        Down2 = VLOAD(Row[4] + x);
+        UpLeft = VLOAD(Row[1] + x - 1);
+        UpRight = VLOAD(Row[1] + x + 1);
+        DownLeft = VLOAD(Row[3] + x - 1);
+        DownRight = VLOAD(Row[3] + x + 1);
+        
+        /* 4*Center - Left2 - Right2 - Up2 - Down2 */
+        Laplacian = VSUB(VSUB(VSUB(VSUB(VMUL(Four, Center), 
+            Left2), Right2), Up2), Down2);
+        
+        GreenAtRB = VMUL(VSUB(VSUB(VSUB(VSUB(VADD(VMUL(Two,
+            VADD(VADD(VADD(Up, Left), Right), Down)), 
+            VMUL(Four, Center)), Left2), Right2), Up2), Down2), OneEighth);
+        RBAtBR = VMUL(VADD(VMUL(Four, 
+            VADD(VADD(VADD(UpLeft, UpRight), DownLeft), DownRight)),
+            VMUL(Three, Laplacian)), OneSixteenth);
+        RBAtGH = VMUL(VADD(VADD(VSUB(VADD(
+            VMUL(Eight, VADD(Left, Right)), VMUL(Ten, Center)),
+            VMUL(Two, VADD(VADD(VADD(VADD(VADD(UpLeft, UpRight), 
+            Left2), Right2), DownLeft), DownRight))), 
+            Up2), Down2), OneSixteenth);
+        RBAtGV = VMUL(VADD(VADD(VSUB(VADD(
+            VMUL(Eight, VADD(Up, Down)), VMUL(Ten, Center)),
+            VMUL(Two, VADD(VADD(VADD(VADD(VADD(UpLeft, UpRight), 
+            Up2), Down2), DownLeft), DownRight))), 
+            Left2), Right2), OneSixteenth);
+        
+        VSTORE(Own + x, VSELECT(Mask, Center, RBAtGH));
+        VSTORE(Green + x, VSELECT(Mask, GreenAtRB, Center));
+        VSTORE(Other + x, VSELECT(Mask, RBAtBR, RBAtGV));
+    }
+    
+    return x;
+}
+
+#endif /* MALVAR_VECTOR_AVX || MALVAR_VECTOR_SSE2 */
+
+
+/**
+ * @brief Malvar-He-Cutler demosaicing of interior pixels in one row
+ * @param Own output row of the non-green color that is present in this row
+ * @param Green output row of green
+ * @param Other output row of the non-green color absent from this row
+ * @param Row pointers to input rows y-2,...,y+2
+ * @param x the first column to compute, must be even
+ * @param xEnd one past the last column to compute
+ * @param Col the column parity (0 or 1) of the non-green pixels in this row
+ *
+ * All columns in [x, xEnd) must be at least two pixels away from the left
+ * and right boundaries.  Pixels are processed a quad row at a time (one
+ * red or blue pixel and one green pixel), so there is no per-pixel parity
+ * test or presence arithmetic.
+ */
+static ATTRIBUTE_ALWAYSINLINE void MalvarInteriorRow(float *Own,
+    float *Green, float *Other, const float *Row[5], int x, int xEnd, int Col)
+{
+    int xRB, xG;
+    
+    
+#if defined(MALVAR_VECTOR_AVX) || defined(MALVAR_VECTOR_SSE2)
+    x = MalvarInteriorRowVector(Own, Green, Other, Row, x, xEnd, Col);
+#endif
+    
+    for(; x + 1 < xEnd; x += 2)
+    {
+        xRB = x + Col;
+        xG = x + 1 - Col;
+        
+        Own[xRB] = Row[2][xRB];
+        Green[xRB] = MALVAR_G_AT_RB(Row, xRB);
+        Other[xRB] = MALVAR_RB_AT_BR(Row, xRB);
+        
+        Green[xG] = Row[2][xG];
+        Own[xG] = MALVAR_RB_AT_G_H(Row, xG);
+        Other[xG] = MALVAR_RB_AT_G_V(Row, xG);
+    }
+    
+    if(x < xEnd)
+    {
+        if((x & 1) == Col)
+        {
+            Own[x] = Row[2][x];
+            Green[x] = MALVAR_G_AT_RB(Row, x);
+            Other[x] = MALVAR_RB_AT_BR(Row, x);
+        }
+        else
+        {
+            Green[x] = Row[2][x];
+            Own[x] = MALVAR_RB_AT_G_H(Row, x);
+            Other[x] = MALVAR_RB_AT_G_V(Row, x);
+        }
+    }
+}
+
+
+/**
+ * @brief Malvar-He-Cutler demosaicing of one row
+ * @param OutputRed, OutputGreen, OutputBlue output rows for row y
+ * @param Row pointers to input rows y-2,...,y+2, NULL if outside the image
+ * @param Width the image width
+ * @param y the row to compute
+ * @param RedX, RedY the coordinates of the upper-rightmost red pixel
+ *
+ * If all five input rows are present, the 2-pixel left and right borders 
+ * are computed with MalvarBorderPixel and the rest of the row with the 
+ * interior kernel.  Otherwise the whole row is a border row.
+ */
+static void MalvarRow(float *OutputRed, float *OutputGreen, 
+    float *OutputBlue, const float *Row[5], int Width, int y,
+    int RedX, int RedY)
+{
+    float *Own = ((y & 1) == RedY) ? OutputRed : OutputBlue;
+    float *Other = ((y & 1) == RedY) ? OutputBlue : OutputRed;
+    int x;
+    
+    
+    if(Row[0] && Row[4] && Width >= 5)
+    {
+        for(x = 0; x < 2; x++)
+            MalvarBorderPixel(OutputRed, OutputGreen, OutputBlue,
+                Row, Width, x, y, RedX, RedY);
+        
+        /* Instantiate the interior kernel for each of the two column 
+           layouts; red and blue rows differ only in the output pointers. */
+        if(((y & 1) == RedY) ? RedX : 1 - RedX)
+            MalvarInteriorRow(Own, OutputGreen, Other, Row, 2, Width - 2, 1);
+        else
+            MalvarInteriorRow(Own, OutputGreen, Other, Row, 2, Width - 2, 0);
+        
+        for(x = Width - 2; x < Width; x++)
+            MalvarBorderPixel(OutputRed, OutputGreen, OutputBlue,
+                Row, Width, x, y, RedX, RedY);
+    }
+    else
+        for(x = 0; x < Width; x++)
+            MalvarBorderPixel(OutputRed, OutputGreen, OutputBlue,
+                Row, Width, x, y, RedX, RedY);
+}
+
+
 /** 
  * @brief Demosaicing using the 5x5 linear method of Malvar et al.
  * @param Output pointer to memory to store the demosaiced image
@@ -47,142 +465,446 @@
  * The Input image is a 2D float array of the input RGB values of size 
  * Width*Height in row-major order.  RedX, RedY are the coordinates of the 
  * upper-rightmost red pixel to specify the CFA pattern.
+ *
+ * The 2-pixel image border is computed with the general boundary-aware 
+ * formulas.  All other pixels use a fast interior kernel that produces 
+ * bit-identical results.  This function produces the same output as
+ * pushing the rows of Input through a malvarstream, but reads Input and
+ * writes Output in place without the ring buffer copies.
  */
 void MalvarDemosaic(float *Output, const float *Input, int Width, int Height, 
     int RedX, int RedY)
 {
-    const int BlueX = 1 - RedX;
-    const int BlueY = 1 - RedY;
     float *OutputRed = Output;
     float *OutputGreen = Output + Width*Height;
     float *OutputBlue = Output + 2*Width*Height;
-    /* Neigh holds a copy of the 5x5 neighborhood around the current point */
-    float Neigh[5][5];
-    /* NeighPresence is used for boundary handling.  It is set to 0 if the 
-       neighbor is beyond the boundaries of the image and 1 otherwise. */
-    int NeighPresence[5][5];
-    int i, j, x, y, nx, ny;
+    const float *Row[5];
+    int k, y, ny;
     
     
-    for(y = 0, i = 0; y < Height; y++)
+    for(y = 0; y < Height; y++)
     {
-        for(x = 0; x < Width; x++, i++)
+        for(k = 0; k < 5; k++)
         {
-            /* 5x5 neighborhood around the point (x,y) is copied into Neigh */
-            for(ny = -2, j = x + Width*(y - 2); ny <= 2; ny++, j += Width)
-            {
-                for(nx = -2; nx <= 2; nx++)
-                {
-                    if(0 <= x + nx && x + nx < Width 
-                        && 0 <= y + ny && y + ny < Height)
-                    {
-                        Neigh[2 + nx][2 + ny] = Input[j + nx];
-                        NeighPresence[2 + nx][2 + ny] = 1;
-                    }
-                    else
-                    {
-                        Neigh[2 + nx][2 + ny] = 0;
-                        NeighPresence[2 + nx][2 + ny] = 0;
-                    }
-                }
-            }
+            ny = y + k - 2;
+            Row[k] = (0 <= ny && ny < Height) ? Input + Width*ny : NULL;
+        }
+        
+        MalvarRow(OutputRed + Width*y, OutputGreen + Width*y, 
+            OutputBlue + Width*y, Row, Width, y, RedX, RedY);
+    }
+}
+
 
-            if((x & 1) == RedX && (y & 1) == RedY)
+
+/** 
+ * @brief Round Num / 2^Shift to nearest and clamp to [0, Max]
+ *
+ * Ties are rounded up.  Negative numerators are clamped to zero before
+ * shifting, so no right shift of a negative value is performed.
+ */
+static int32_t RoundShiftClamp(int32_t Num, int Shift, int32_t Max)
+{
+    Num = (Num < 0) ? 0 : Num;
+    Num = (Num + (1 << (Shift - 1))) >> Shift;
+    return (Num < Max) ? Num : Max;
+}
+
+
+/** @brief Round Num / Den to nearest and clamp to [0, Max] */
+static int32_t RoundDivClamp(int32_t Num, int32_t Den, int32_t Max)
+{
+    if(Num <= 0 || Den <= 0)
+        return 0;
+    
+    Num = (2*Num + Den) / (2*Den);
+    return (Num < Max) ? Num : Max;
+}
+
+
+/**
+ * @brief Integer Malvar-He-Cutler demosaicing at one pixel with boundaries
+ * @param OutputRow interleaved RGB output row for row y
+ * @param Row pointers to input rows y-2,...,y+2, NULL if outside the image
+ * @param Width the image width
+ * @param x the column to compute
+ * @param y the row to compute
+ * @param RedX, RedY the coordinates of the upper-rightmost red pixel
+ * @param Max the maximum sample value, 2^BitDepth - 1
+ *
+ * This is the int32 counterpart of MalvarBorderPixel.  The numerator and
+ * denominator of each filter are accumulated exactly, so the only error is
+ * the final rounding to nearest.
+ */
+static void MalvarBorderPixelU16(uint16_t *OutputRow, const uint16_t *Row[5],
+    int Width, int x, int y, int RedX, int RedY, int32_t Max)
+{
+    uint16_t *Pixel = OutputRow + 3*x;
+    int32_t Neigh[5][5];
+    int32_t NeighPresence[5][5];
+    int32_t GNum, GDen, XNum, XDen, HNum, HDen, VNum, VDen;
+    int nx, ny;
+    
+    
+    for(ny = -2; ny <= 2; ny++)
+        for(nx = -2; nx <= 2; nx++)
+            if(0 <= x + nx && x + nx < Width && Row[2 + ny])
             {
-                /* Center pixel is red */
-                OutputRed[i] = Input[i];
-                OutputGreen[i] = (2*(Neigh[2][1] + Neigh[1][2]
-                    + Neigh[3][2] + Neigh[2][3])
-                    + (NeighPresence[0][2] + NeighPresence[4][2]
-                    + NeighPresence[2][0] + NeighPresence[2][4])*Neigh[2][2] 
-                    - Neigh[0][2] - Neigh[4][2]
-                    - Neigh[2][0] - Neigh[2][4])
-                    / (2*(NeighPresence[2][1] + NeighPresence[1][2]
-                    + NeighPresence[3][2] + NeighPresence[2][3]));
-                OutputBlue[i] = (4*(Neigh[1][1] + Neigh[3][1]
-                    + Neigh[1][3] + Neigh[3][3]) +
-                    3*((NeighPresence[0][2] + NeighPresence[4][2]
-                    + NeighPresence[2][0] + NeighPresence[2][4])*Neigh[2][2] 
-                    - Neigh[0][2] - Neigh[4][2]
-                    - Neigh[2][0] - Neigh[2][4])) 
-                    / (4*(NeighPresence[1][1] + NeighPresence[3][1]
-                    + NeighPresence[1][3] + NeighPresence[3][3]));
+                Neigh[2 + nx][2 + ny] = Row[2 + ny][x + nx];
+                NeighPresence[2 + nx][2 + ny] = 1;
             }
-            else if((x & 1) == BlueX && (y & 1) == BlueY)
+            else
             {
-                /* Center pixel is blue */
-                OutputBlue[i] = Input[i];
-                OutputGreen[i] = (2*(Neigh[2][1] + Neigh[1][2]
-                    + Neigh[3][2] + Neigh[2][3])
-                    + (NeighPresence[0][2] + NeighPresence[4][2]
-                    + NeighPresence[2][0] + NeighPresence[2][4])*Neigh[2][2] 
-                    - Neigh[0][2] - Neigh[4][2]
-                    - Neigh[2][0] - Neigh[2][4])
-                    / (2*(NeighPresence[2][1] + NeighPresence[1][2]
-                    + NeighPresence[3][2] + NeighPresence[2][3]));
-                OutputRed[i] = (4*(Neigh[1][1] + Neigh[3][1]
-                    + Neigh[1][3] + Neigh[3][3]) +
-                    3*((NeighPresence[0][2] + NeighPresence[4][2]
-                    + NeighPresence[2][0] + NeighPresence[2][4])*Neigh[2][2] 
-                    - Neigh[0][2] - Neigh[4][2]
-                    - Neigh[2][0] - Neigh[2][4])) 
-                    / (4*(NeighPresence[1][1] + NeighPresence[3][1]
-                    + NeighPresence[1][3] + NeighPresence[3][3]));
+                Neigh[2 + nx][2 + ny] = 0;
+                NeighPresence[2 + nx][2 + ny] = 0;
             }
-            else
+    
+    if(((x + y) & 1) != ((RedX + RedY) & 1))
+    {
+        /* Center pixel is green */
+        HNum = 8*(Neigh[1][2] + Neigh[3][2])
+            + (2*(NeighPresence[1][1] + NeighPresence[3][1]
+            + NeighPresence[0][2] + NeighPresence[4][2]
+            + NeighPresence[1][3] + NeighPresence[3][3])
+            - NeighPresence[2][0] - NeighPresence[2][4])*Neigh[2][2]
+            - 2*(Neigh[1][1] + Neigh[3][1]
+            + Neigh[0][2] + Neigh[4][2]
+            + Neigh[1][3] + Neigh[3][3])
+            + Neigh[2][0] + Neigh[2][4];
+        HDen = 8*(NeighPresence[1][2] + NeighPresence[3][2]);
+        VNum = 8*(Neigh[2][1] + Neigh[2][3])
+            + (2*(NeighPresence[1][1] + NeighPresence[3][1]
+            + NeighPresence[2][0] + NeighPresence[2][4]
+            + NeighPresence[1][3] + NeighPresence[3][3])
+            - NeighPresence[0][2] - NeighPresence[4][2])*Neigh[2][2]
+            - 2*(Neigh[1][1] + Neigh[3][1]
+            + Neigh[2][0] + Neigh[2][4]
+            + Neigh[1][3] + Neigh[3][3])
+            + Neigh[0][2] + Neigh[4][2];
+        VDen = 8*(NeighPresence[2][1] + NeighPresence[2][3]);
+        
+        Pixel[1] = (uint16_t)Neigh[2][2];
+        
+        if((y & 1) == RedY)
+        {
+            /* Left and right neighbors are red */
+            Pixel[0] = (uint16_t)RoundDivClamp(HNum, HDen, Max);
+            Pixel[2] = (uint16_t)RoundDivClamp(VNum, VDen, Max);
+        }
+        else
+        {
+            /* Left and right neighbors are blue */
+            Pixel[0] = (uint16_t)RoundDivClamp(VNum, VDen, Max);
+            Pixel[2] = (uint16_t)RoundDivClamp(HNum, HDen, Max);
+        }
+    }
+    else
+    {
+        GNum = 2*(Neigh[2][1] + Neigh[1][2]
+            + Neigh[3][2] + Neigh[2][3])
+            + (NeighPresence[0][2] + NeighPresence[4][2]
+            + NeighPresence[2][0] + NeighPresence[2][4])*Neigh[2][2] 
+            - Neigh[0][2] - Neigh[4][2]
+            - Neigh[2][0] - Neigh[2][4];
+        GDen = 2*(NeighPresence[2][1] + NeighPresence[1][2]
+            + NeighPresence[3][2] + NeighPresence[2][3]);
+        XNum = 4*(Neigh[1][1] + Neigh[3][1]
+            + Neigh[1][3] + Neigh[3][3]) +
+            3*((NeighPresence[0][2] + NeighPresence[4][2]
+            + NeighPresence[2][0] + NeighPresence[2][4])*Neigh[2][2] 
+            - Neigh[0][2] - Neigh[4][2]
+            - Neigh[2][0] - Neigh[2][4]);
+        XDen = 4*(NeighPresence[1][1] + NeighPresence[3][1]
+            + NeighPresence[1][3] + NeighPresence[3][3]);
+        
+        Pixel[1] = (uint16_t)RoundDivClamp(GNum, GDen, Max);
+        
+        if((y & 1) == RedY)
+        {
+            /* Center pixel is red */
+            Pixel[0] = (uint16_t)Neigh[2][2];
+            Pixel[2] = (uint16_t)RoundDivClamp(XNum, XDen, Max);
+        }
+        else
+        {
+            /* Center pixel is blue */
+            Pixel[0] = (uint16_t)RoundDivClamp(XNum, XDen, Max);
+            Pixel[2] = (uint16_t)Neigh[2][2];
+        }
+    }
+}
+
+
+/**
+ * @brief Integer Malvar-He-Cutler demosaicing of interior pixels in one row
+ * @param OutputRow interleaved RGB output row
+ * @param Row pointers to input rows y-2,...,y+2
+ * @param x the first column to compute, must be even
+ * @param xEnd one past the last column to compute
+ * @param Col the column parity (0 or 1) of the non-green pixels in this row
+ * @param Own channel index (0 or 2) of the non-green color in this row
+ * @param Max the maximum sample value, 2^BitDepth - 1
+ */
+static ATTRIBUTE_ALWAYSINLINE void MalvarInteriorRowU16(uint16_t *OutputRow,
+    const uint16_t *Row[5], int x, int xEnd, int Col, int Own, int32_t Max)
+{
+    const int Other = 2 - Own;
+    uint16_t *Pixel;
+    int xRB, xG;
+    
+    
+    for(; x + 1 < xEnd; x += 2)
+    {
+        xRB = x + Col;
+        xG = x + 1 - Col;
+        
+        Pixel = OutputRow + 3*xRB;
+        Pixel[Own] = Row[2][xRB];
+        Pixel[1] = (uint16_t)RoundShiftClamp(
+            MALVAR_G_AT_RB_NUM(Row, xRB), 3, Max);
+        Pixel[Other] = (uint16_t)RoundShiftClamp(
+            MALVAR_RB_AT_BR_NUM(Row, xRB), 4, Max);
+        
+        Pixel = OutputRow + 3*xG;
+        Pixel[1] = Row[2][xG];
+        Pixel[Own] = (uint16_t)RoundShiftClamp(
+            MALVAR_RB_AT_G_H_NUM(Row, xG), 4, Max);
+        Pixel[Other] = (uint16_t)RoundShiftClamp(
+            MALVAR_RB_AT_G_V_NUM(Row, xG), 4, Max);
+    }
+    
+    if(x < xEnd)
+    {
+        Pixel = OutputRow + 3*x;
+        
+        if((x & 1) == Col)
+        {
+            Pixel[Own] = Row[2][x];
+            Pixel[1] = (uint16_t)RoundShiftClamp(
+                MALVAR_G_AT_RB_NUM(Row, x), 3, Max);
+            Pixel[Other] = (uint16_t)RoundShiftClamp(
+                MALVAR_RB_AT_BR_NUM(Row, x), 4, Max);
+        }
+        else
+        {
+            Pixel[1] = Row[2][x];
+            Pixel[Own] = (uint16_t)RoundShiftClamp(
+                MALVAR_RB_AT_G_H_NUM(Row, x), 4, Max);
+            Pixel[Other] = (uint16_t)RoundShiftClamp(
+                MALVAR_RB_AT_G_V_NUM(Row, x), 4, Max);
+        }
+    }
+}
+
+
+/** 
+ * @brief Fixed-point Malvar-He-Cutler demosaicing of integer raw data
+ * @param Output pointer to memory to store the demosaiced image
+ * @param Input the input image as a flattened 2D array
+ * @param Width, Height the image dimensions, at least 2x2
+ * @param RedX, RedY the coordinates of the upper-rightmost red pixel
+ * @param BitDepth number of significant bits per sample, 1 to 16
+ * @return 1 on success, 0 on failure
+ *
+ * This is an integer implementation of MalvarDemosaic for raw sensor data
+ * such as 10-, 12-, or 14-bit frames.  Input is a 2D uint16_t array of 
+ * size Width*Height in row-major order with samples in [0, 2^BitDepth - 1].
+ * The Output is written as interleaved RGB, 3*Width*Height uint16_t 
+ * values.
+ *
+ * Filters are evaluated in int32 arithmetic, which cannot overflow for
+ * BitDepth up to 16.  Each interpolated value is the exact filter result
+ * rounded to nearest (ties upward) and clamped to [0, 2^BitDepth - 1].  
+ * Compared to rounding the output of MalvarDemosaic, results therefore 
+ * differ only where the float computation rounds across a tie.
+ */
+int MalvarDemosaicU16(uint16_t *Output, const uint16_t *Input, 
+    int Width, int Height, int RedX, int RedY, int BitDepth)
+{
+    const int32_t Max = (int32_t)((1L << BitDepth) - 1);
+    const uint16_t *Row[5];
+    uint16_t *OutputRow;
+    int k, x, y, ny;
+    
+    
+    if(BitDepth < 1 || BitDepth > 16)
+    {
+        ErrorMessage("Bit depth must be between 1 and 16.\n");
+        return 0;
+    }
+    else if(Width < 2 || Height < 2)
+    {
+        ErrorMessage("Image is too small (%dx%d).\n", Width, Height);
+        return 0;
+    }
+    
+    for(y = 0; y < Height; y++)
+    {
+        OutputRow = Output + 3*Width*y;
+        
+        for(k = 0; k < 5; k++)
+        {
+            ny = y + k - 2;
+            Row[k] = (0 <= ny && ny < Height) ? Input + Width*ny : NULL;
+        }
+        
+        if(Row[0] && Row[4] && Width >= 5)
+        {
+            for(x = 0; x < 2; x++)
+                MalvarBorderPixelU16(OutputRow, Row, Width, x, y, 
+                    RedX, RedY, Max);
+            
+            /* One kernel instance per row layout.  Row y is laid out 
+               like the top row of the phase with red at 
+               (RedX, (y & 1) ^ RedY). */
+            switch(CFA_PHASE(RedX, (y & 1) ^ RedY))
             {
-                /* Center pixel is green */
-                OutputGreen[i] = Input[i];
-                
-                if((y & 1) == RedY)
-                {
-                    /* Left and right neighbors are red */
-                    OutputRed[i] = (8*(Neigh[1][2] + Neigh[3][2])
-                        + (2*(NeighPresence[1][1] + NeighPresence[3][1]
-                        + NeighPresence[0][2] + NeighPresence[4][2]
-                        + NeighPresence[1][3] + NeighPresence[3][3])
-                        - NeighPresence[2][0] - NeighPresence[2][4])*Neigh[2][2]
-                        - 2*(Neigh[1][1] + Neigh[3][1]
-                        + Neigh[0][2] + Neigh[4][2]
-                        + Neigh[1][3] + Neigh[3][3])
-                        + Neigh[2][0] + Neigh[2][4]) 
-                        / (8*(NeighPresence[1][2] + NeighPresence[3][2]));
-                    OutputBlue[i] = (8*(Neigh[2][1] + Neigh[2][3])
-                        + (2*(NeighPresence[1][1] + NeighPresence[3][1]
-                        + NeighPresence[2][0] + NeighPresence[2][4]
-                        + NeighPresence[1][3] + NeighPresence[3][3])
-                        - NeighPresence[0][2] - NeighPresence[4][2])*Neigh[2][2]
-                        - 2*(Neigh[1][1] + Neigh[3][1]
-                        + Neigh[2][0] + Neigh[2][4]
-                        + Neigh[1][3] + Neigh[3][3])
-                        + Neigh[0][2] + Neigh[4][2]) 
-                        / (8*(NeighPresence[2][1] + NeighPresence[2][3]));
-                }
-                else
-                {
-                    /* Left and right neighbors are blue */
-                    OutputRed[i] = (8*(Neigh[2][1] + Neigh[2][3])
-                        + (2*(NeighPresence[1][1] + NeighPresence[3][1]
-                        + NeighPresence[2][0] + NeighPresence[2][4]
-                        + NeighPresence[1][3] + NeighPresence[3][3])
-                        - NeighPresence[0][2] - NeighPresence[4][2])*Neigh[2][2]
-                        - 2*(Neigh[1][1] + Neigh[3][1]
-                        + Neigh[2][0] + Neigh[2][4]
-                        + Neigh[1][3] + Neigh[3][3])
-                        + Neigh[0][2] + Neigh[4][2]) 
-                        / (8*(NeighPresence[2][1] + NeighPresence[2][3]));
-                    OutputBlue[i] = (8*(Neigh[1][2] + Neigh[3][2])
-                        + (2*(NeighPresence[1][1] + NeighPresence[3][1]
-                        + NeighPresence[0][2] + NeighPresence[4][2]
-                        + NeighPresence[1][3] + NeighPresence[3][3])
-                        - NeighPresence[2][0] - NeighPresence[2][4])*Neigh[2][2]
-                        - 2*(Neigh[1][1] + Neigh[3][1]
-                        + Neigh[0][2] + Neigh[4][2]
-                        + Neigh[1][3] + Neigh[3][3])
-                        + Neigh[2][0] + Neigh[2][4]) 
-                        / (8*(NeighPresence[1][2] + NeighPresence[3][2]));
-                }
+            case CFA_RGGB:
+                MalvarInteriorRowU16(OutputRow, Row, 2, Width - 2, 
+                    0, 0, Max);
+                break;
+            case CFA_GRBG:
+                MalvarInteriorRowU16(OutputRow, Row, 2, Width - 2, 
+                    1, 0, Max);
+                break;
+            case CFA_GBRG:
+                MalvarInteriorRowU16(OutputRow, Row, 2, Width - 2, 
+                    1, 2, Max);
+                break;
+            default:
+                MalvarInteriorRowU16(OutputRow, Row, 2, Width - 2, 
+                    0, 2, Max);
+                break;
             }
+            
+            for(x = Width - 2; x < Width; x++)
+                MalvarBorderPixelU16(OutputRow, Row, Width, x, y, 
+                    RedX, RedY, Max);
         }
+        else
+            for(x = 0; x < Width; x++)
+                MalvarBorderPixelU16(OutputRow, Row, Width, x, y, 
+                    RedX, RedY, Max);
     }
+    
+    return 1;
+}
+
+/**
+ * @brief Compute output row y of a stream and pass it to the row function
+ * @param Stream the stream
+ * @param y the row to compute, rows up to min(y + 2, Height - 1) must have
+ *    been pushed
+ */
+static void MalvarStreamEmitRow(malvarstream *Stream, int y)
+{
+    const int Width = Stream->Width;
+    float *OutputRed = Stream->OutputRow;
+    float *OutputGreen = Stream->OutputRow + Width;
+    float *OutputBlue = Stream->OutputRow + 2*Width;
+    const float *Row[5];
+    int k, ny;
+    
+    
+    for(k = 0; k < 5; k++)
+    {
+        ny = y + k - 2;
+        Row[k] = (0 <= ny && ny < Stream->Height) ? 
+            Stream->Ring + Width*(ny % 5) : NULL;
+    }
+    
+    MalvarRow(OutputRed, OutputGreen, OutputBlue, Row, Width, y, 
+        Stream->RedX, Stream->RedY);
+    Stream->RowFunc(OutputRed, OutputGreen, OutputBlue, y, 
+        Stream->RowFuncParam);
+}
+
+
+/**
+ * @brief Initialize row-streaming Malvar-He-Cutler demosaicing
+ * @param Stream the stream to initialize
+ * @param Width, Height the image dimensions
+ * @param RedX, RedY the coordinates of the upper-rightmost red pixel
+ * @param RowFunc function to call with each finished output row
+ * @param RowFuncParam pointer passed through to RowFunc
+ * @return 1 on success, 0 on failure
+ *
+ * The stream holds a ring buffer of 5 input rows and one planar RGB output
+ * row, so memory is 8*Width floats regardless of Height.  Rows are then 
+ * fed to MalvarStreamPush in top-to-bottom order.
+ */
+int MalvarStreamInit(malvarstream *Stream, int Width, int Height, 
+    int RedX, int RedY, malvarrowfunc RowFunc, void *RowFuncParam)
+{
+    Stream->Ring = NULL;
+    Stream->OutputRow = NULL;
+    
+    if(Width <= 0 || Height <= 0 || !RowFunc)
+    {
+        ErrorMessage("Invalid stream parameters.\n");
+        return 0;
+    }
+    else if(!(Stream->Ring = (float *)Malloc(sizeof(float)*5*Width))
+        || !(Stream->OutputRow = (float *)Malloc(sizeof(float)*3*Width)))
+    {
+        MalvarStreamFree(Stream);
+        return 0;
+    }
+    
+    Stream->RowFunc = RowFunc;
+    Stream->RowFuncParam = RowFuncParam;
+    Stream->Width = Width;
+    Stream->Height = Height;
+    Stream->RedX = RedX;
+    Stream->RedY = RedY;
+    Stream->NumRowsIn = 0;
+    return 1;
+}
+
+
+/**
+ * @brief Push the next input row into a Malvar-He-Cutler stream
+ * @param Stream the stream
+ * @param InputRow the next row of the flattened CFA image, Width samples
+ * @return 1 on success, 0 if all Height rows were already pushed
+ *
+ * Output row y is finished as soon as input row y + 2 arrives and is
+ * passed to the stream's row function from within this call.  When the 
+ * last input row is pushed, the remaining output rows are emitted, so
+ * every output row has been delivered once MalvarStreamPush returns for
+ * row Height - 1.
+ */
+int MalvarStreamPush(malvarstream *Stream, const float *InputRow)
+{
+    int y;
+    
+    
+    if(Stream->NumRowsIn >= Stream->Height)
+    {
+        ErrorMessage("Too many rows pushed to stream.\n");
+        return 0;
+    }
+    
+    y = Stream->NumRowsIn++;
+    memcpy(Stream->Ring + Stream->Width*(y % 5), InputRow, 
+        sizeof(float)*Stream->Width);
+    
+    if(y >= 2)
+        MalvarStreamEmitRow(Stream, y - 2);
+    
+    if(Stream->NumRowsIn == Stream->Height)
+        for(y = (y >= 2) ? y - 1 : 0; y < Stream->Height; y++)
+            MalvarStreamEmitRow(Stream, y);
+    
+    return 1;
+}
+
+
+/** @brief Free memory associated with a Malvar-He-Cutler stream */
+void MalvarStreamFree(malvarstream *Stream)
+{
+    Free(Stream->OutputRow);
+    Free(Stream->Ring);
+    Stream->OutputRow = NULL;
+    Stream->Ring = NULL;
 }
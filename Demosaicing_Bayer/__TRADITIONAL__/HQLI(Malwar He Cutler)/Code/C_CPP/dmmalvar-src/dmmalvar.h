@@ -17,7 +17,47 @@
 #ifndef _DMMALVAR_H_
 #define _DMMALVAR_H_
 
+#include "basic.h"
+
+/** 
+ * @brief Callback receiving a finished output row from a malvarstream
+ *
+ * Red, Green, Blue point to the Width samples of output row y.  They are
+ * only valid for the duration of the call.
+ */
+typedef void (*malvarrowfunc)(const float *Red, const float *Green, 
+    const float *Blue, int y, void *Param);
+
+/** @brief State of the row-streaming Malvar-He-Cutler demosaicing */
+typedef struct
+{
+    /** @brief Ring buffer holding the 5 most recent input rows */
+    float *Ring;
+    /** @brief Planar red, green, blue output row */
+    float *OutputRow;
+    /** @brief Function called for every finished output row */
+    malvarrowfunc RowFunc;
+    /** @brief Pointer passed through to RowFunc */
+    void *RowFuncParam;
+    /** @brief Image dimensions */
+    int Width, Height;
+    /** @brief CFA pattern upper-rightmost red pixel coordinates */
+    int RedX, RedY;
+    /** @brief Number of input rows pushed so far */
+    int NumRowsIn;
+} malvarstream;
+
 void MalvarDemosaic(float *Output, const float *Input, 
     int Width, int Height, int RedX, int RedY);
 
+int MalvarDemosaicU16(uint16_t *Output, const uint16_t *Input, 
+    int Width, int Height, int RedX, int RedY, int BitDepth);
+
+int MalvarStreamInit(malvarstream *Stream, int Width, int Height, 
+    int RedX, int RedY, malvarrowfunc RowFunc, void *RowFuncParam);
+
+int MalvarStreamPush(malvarstream *Stream, const float *InputRow);
+
+void MalvarStreamFree(malvarstream *Stream);
+
 #endif /* _DMMALVAR_H_ */
@@ -0,0 +1,334 @@
+/**
+ * @file dmmalvarcmp.c
+ * @brief Compare fixed-point and float Malvar-He-Cutler demosaicing
+ * @author Demosaicing_Bayer contributors
+ *
+ * This program mosaics an image, quantizes the mosaic to integer raw data
+ * of a given bit depth, and demosaics it with both MalvarDemosaicU16 and
+ * MalvarDemosaic.  The float result is rounded to the same bit depth and
+ * the two outputs are compared sample by sample.  The mosaic is also 
+ * pushed row by row through a malvarstream, whose output must be identical
+ * to MalvarDemosaic.  The exit status is zero if no sample of the 
+ * fixed-point output differs by more than one least significant bit and 
+ * the stream output matches exactly.
+ *
+ *
+ * Copyright (c) 2026, Demosaicing_Bayer contributors
+ * All rights reserved.
+ *
+ * This program is provided for scientific and educational only: you
+ * can use and/or modify it for these purposes, but you are not allowed
+ * to redistribute this work or derivative works in source or
+ * executable form. A license must be obtained from the patent right
+ * holders for any other use.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "imageio.h"
+#include "dmbilinear.h"
+#include "dmmalvar.h"
+
+
+/** @brief struct of program parameters */
+typedef struct
+{
+    /** @brief Input file name */
+    char *InputFile;
+    /** @brief Bit depth of the simulated raw data */
+    int BitDepth;
+    /** @brief Index of the CFA pattern to test, or -1 to test all four */
+    int Pattern;
+} programparams;
+
+
+static int ParseParams(programparams *Param, int argc, char *argv[]);
+
+/** @brief Planar RGB image filled by CopyStreamRow */
+typedef struct
+{
+    /** @brief Image data in row-major planar order */
+    float *Data;
+    /** @brief Image dimensions */
+    int Width, Height;
+} streamimage;
+
+
+/** @brief CFA pattern names, indexed by RedX + 2*RedY */
+static const char *PatternNames[4] = {"RGGB", "GRBG", "GBRG", "BGGR"};
+
+
+static void PrintHelpMessage()
+{
+    printf("Fixed-point vs. float Malvar-He-Cutler comparison, 2026\n\n");
+    printf("Usage: dmmalvarcmp [options] <input file>\n\n"
+        "Only " READIMAGE_FORMATS_SUPPORTED " images are supported.\n\n");
+    printf("Options:\n");
+    printf("   -b <number>   Bit depth of the simulated raw data (default 12)\n");
+    printf("   -p <pattern>  CFA pattern to test, RGGB, GRBG, GBRG, or BGGR\n");
+    printf("                 (default: test all four)\n\n");
+    printf("Example:\n"
+        "   dmmalvarcmp -b 12 frog.bmp\n");
+}
+
+
+/** @brief Stream row function copying each output row into a streamimage */
+static void CopyStreamRow(const float *Red, const float *Green, 
+    const float *Blue, int y, void *Param)
+{
+    streamimage *Image = (streamimage *)Param;
+    const long NumPixels = ((long)Image->Width)*((long)Image->Height);
+    float *Dest = Image->Data + ((long)Image->Width)*y;
+    
+    memcpy(Dest, Red, sizeof(float)*Image->Width);
+    memcpy(Dest + NumPixels, Green, sizeof(float)*Image->Width);
+    memcpy(Dest + 2*NumPixels, Blue, sizeof(float)*Image->Width);
+}
+
+
+/**
+ * @brief Compare MalvarDemosaicU16 with MalvarDemosaic for one pattern
+ * @param Image the input RGB image in row-major planar order
+ * @param Width, Height the image dimensions
+ * @param RedX, RedY the coordinates of the upper-rightmost red pixel
+ * @param BitDepth bit depth of the simulated raw data
+ * @param MaxDiff set to the maximum absolute difference in LSBs
+ * @param NumStreamDiffs set to the number of samples where the malvarstream
+ *    output differs from MalvarDemosaic
+ * @return 1 on success, 0 on failure
+ */
+static int ComparePattern(const float *Image, int Width, int Height,
+    int RedX, int RedY, int BitDepth, long *MaxDiff, long *NumStreamDiffs)
+{
+    const long NumPixels = ((long)Width)*((long)Height);
+    const float Max = (float)((1L << BitDepth) - 1);
+    float *Flat = NULL, *FloatOutput = NULL, *StreamOutput = NULL;
+    uint16_t *Raw = NULL, *IntOutput = NULL;
+    malvarstream Stream;
+    streamimage StreamImage;
+    unsigned long StartTime, FloatTime, IntTime;
+    long i, NumDiffs = 0, Diff;
+    int Channel, y, Success = 0;
+    float Value;
+
+
+    if(!(Flat = (float *)Malloc(sizeof(float)*NumPixels))
+        || !(FloatOutput = (float *)Malloc(sizeof(float)*3*NumPixels))
+        || !(StreamOutput = (float *)Malloc(sizeof(float)*3*NumPixels))
+        || !(Raw = (uint16_t *)Malloc(sizeof(uint16_t)*NumPixels))
+        || !(IntOutput = (uint16_t *)Malloc(sizeof(uint16_t)*3*NumPixels)))
+        goto Catch;
+
+    /* Simulate integer raw data of the specified bit depth */
+    CfaFlatten(Flat, Image, Width, Height, RedX, RedY);
+
+    for(i = 0; i < NumPixels; i++)
+    {
+        Value = ROUNDF(Flat[i]*Max);
+        Raw[i] = (uint16_t)((Value < 0) ? 0 : ((Value > Max) ? Max : Value));
+        Flat[i] = (float)Raw[i];
+    }
+
+    StartTime = Clock();
+    MalvarDemosaic(FloatOutput, Flat, Width, Height, RedX, RedY);
+    FloatTime = Clock() - StartTime;
+
+    StartTime = Clock();
+
+    if(!MalvarDemosaicU16(IntOutput, Raw, Width, Height, RedX, RedY,
+        BitDepth))
+        goto Catch;
+
+    IntTime = Clock() - StartTime;
+
+    /* Push the mosaic row by row through a stream */
+    StreamImage.Data = StreamOutput;
+    StreamImage.Width = Width;
+    StreamImage.Height = Height;
+
+    if(!MalvarStreamInit(&Stream, Width, Height, RedX, RedY, 
+        CopyStreamRow, &StreamImage))
+        goto Catch;
+
+    for(y = 0; y < Height; y++)
+        MalvarStreamPush(&Stream, Flat + ((long)Width)*y);
+
+    MalvarStreamFree(&Stream);
+
+    for(i = 0, *NumStreamDiffs = 0; i < 3*NumPixels; i++)
+        if(StreamOutput[i] != FloatOutput[i])
+            (*NumStreamDiffs)++;
+
+    /* Round the float output and compare with the integer output */
+    for(Channel = 0, *MaxDiff = 0; Channel < 3; Channel++)
+        for(i = 0; i < NumPixels; i++)
+        {
+            Value = ROUNDF(FloatOutput[i + NumPixels*Channel]);
+            Value = (Value < 0) ? 0 : ((Value > Max) ? Max : Value);
+            Diff = labs((long)Value - (long)IntOutput[3*i + Channel]);
+
+            if(Diff)
+            {
+                NumDiffs++;
+
+                if(Diff > *MaxDiff)
+                    *MaxDiff = Diff;
+            }
+        }
+
+    printf("%s  max diff %ld LSB  %ld of %ld samples differ  "
+        "float %lu ms  fixed %lu ms  stream %ld differ\n", 
+        PatternNames[RedX + 2*RedY], *MaxDiff, NumDiffs, 3*NumPixels, 
+        FloatTime, IntTime, *NumStreamDiffs);
+    Success = 1;
+Catch:
+    Free(IntOutput);
+    Free(Raw);
+    Free(StreamOutput);
+    Free(FloatOutput);
+    Free(Flat);
+    return Success;
+}
+
+
+int main(int argc, char *argv[])
+{
+    programparams Param;
+    float *Image = NULL;
+    long MaxDiff, NumStreamDiffs;
+    int Width, Height, Pattern, Status = 1;
+
+
+    if(!ParseParams(&Param, argc, argv))
+        return 0;
+
+    /* Read the input image */
+    if(!(Image = (float *)ReadImage(&Width, &Height,
+        Param.InputFile, IMAGEIO_FLOAT | IMAGEIO_RGB | IMAGEIO_PLANAR)))
+        goto Catch;
+
+    if(Width < 4 || Height < 4)
+    {
+        ErrorMessage("Image is too small (%dx%d).\n", Width, Height);
+        goto Catch;
+    }
+
+    printf("Comparing fixed-point and float paths at %d bits (%dx%d)\n\n",
+        Param.BitDepth, Width, Height);
+
+    for(Pattern = 0, Status = 0; Pattern < 4; Pattern++)
+        if(Param.Pattern < 0 || Param.Pattern == Pattern)
+        {
+            if(!ComparePattern(Image, Width, Height, Pattern & 1,
+                Pattern >> 1, Param.BitDepth, &MaxDiff, &NumStreamDiffs))
+            {
+                Status = 1;
+                goto Catch;
+            }
+
+            if(MaxDiff > 1 || NumStreamDiffs)
+                Status = 1;
+        }
+
+    printf("\n%s\n", (Status) ? "FAILED" : "PASSED");
+Catch:
+    Free(Image);
+    return Status;
+}
+
+
+static int ParseParams(programparams *Param, int argc, char *argv[])
+{
+    char *OptionString;
+    char OptionChar;
+    int i;
+
+
+    if(argc < 2)
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    /* Set parameter defaults */
+    Param->InputFile = 0;
+    Param->BitDepth = 12;
+    Param->Pattern = -1;
+
+    for(i = 1; i < argc;)
+    {
+        if(argv[i] && argv[i][0] == '-')
+        {
+            if((OptionChar = argv[i][1]) == 0)
+            {
+                ErrorMessage("Invalid parameter format.\n");
+                return 0;
+            }
+
+            if(argv[i][2])
+                OptionString = &argv[i][2];
+            else if(++i < argc)
+                OptionString = argv[i];
+            else
+            {
+                ErrorMessage("Invalid parameter format.\n");
+                return 0;
+            }
+
+            switch(OptionChar)
+            {
+            case 'b':
+                Param->BitDepth = atoi(OptionString);
+
+                if(Param->BitDepth < 1 || Param->BitDepth > 16)
+                {
+                    ErrorMessage("Bit depth must be between 1 and 16.\n");
+                    return 0;
+                }
+                break;
+            case 'p':
+                for(Param->Pattern = 3; Param->Pattern >= 0;
+                    Param->Pattern--)
+                    if(!strcmp(OptionString, PatternNames[Param->Pattern]))
+                        break;
+
+                if(Param->Pattern < 0)
+                {
+                    ErrorMessage(
+                        "CFA pattern must be RGGB, GRBG, GBRG, or BGGR\n");
+                    return 0;
+                }
+                break;
+            case '-':
+                PrintHelpMessage();
+                return 0;
+            default:
+                if(isprint(OptionChar))
+                    ErrorMessage("Unknown option \"-%c\".\n", OptionChar);
+                else
+                    ErrorMessage("Unknown option.\n");
+
+                return 0;
+            }
+
+            i++;
+        }
+        else
+        {
+            if(!Param->InputFile)
+                Param->InputFile = argv[i];
+
+            i++;
+        }
+    }
+
+    if(!Param->InputFile)
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    return 1;
+}
@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2026, Demosaicing_Bayer contributors
+ * All rights reserved.
+ *
+ * This program is free software: you can use, modify and/or
+ * redistribute it under the terms of the simplified BSD License. You
+ * should have received a copy of this license along this program. If
+ * not, see <http://www.opensource.org/licenses/bsd-license.html>.
+ *
+ * The reference_* functions reproduce the original kernels of
+ * libdemosaicking.cpp by A. Buades, and this program links with that
+ * file. Their license terms and patent warning still apply to them.
+ */
+
+/**
+ * @file demosaickingBench.cpp
+ * @brief micro-benchmark of the Adams-Hamilton and bilinear kernels
+ *
+ * This program builds synthetic 4K (3840x2160) and 8K (7680x4320)
+ * Bayer frames and times demosaicking_adams and
+ * demosaicking_bilinear_red_blue against a reference implementation
+ * that walks the image column by column and tests the color of each
+ * pixel in a CFA mask, as these kernels were first written. The
+ * maximum difference between both outputs is reported, it must be 0.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "libdemosaicking.h"
+
+#define GREENPOSITION 0
+#define REDPOSITION 1
+#define BLUEPOSITION 2
+
+
+/**
+ * @brief CFA mask of color per pixel
+ */
+static unsigned char *reference_mask(int redx, int redy, int width, int height)
+{
+    unsigned char *mask = (unsigned char *) malloc(width * height);
+    int bluex = 1 - redx;
+    int bluey = 1 - redy;
+
+    for (int x = 0; x < width; x++)
+        for (int y = 0; y < height; y++)
+        {
+            if (x % 2 == redx && y % 2 == redy)
+                mask[y * width + x] = REDPOSITION;
+            else if (x % 2 == bluex && y % 2 == bluey)
+                mask[y * width + x] = BLUEPOSITION;
+            else
+                mask[y * width + x] = GREENPOSITION;
+        }
+
+    return mask;
+}
+
+
+/**
+ * @brief bilinear interpolation of the differences of one channel,
+ * column by column with a mask test per pixel
+ */
+static void reference_difference(float *oc, unsigned char *mask,
+                                 int position, int cx, int cy,
+                                 int width, int height)
+{
+    for (int x = 0; x < width; x++)
+        for (int y = 0; y < height; y++)
+            if (mask[y * width + x] != position)
+            {
+                int gn, gs, ge, gw;
+
+                if (y > 0) gn = y - 1; else gn = 1;
+                if (y < height - 1) gs = y + 1; else gs = height - 2;
+                if (x < width - 1) ge = x + 1; else ge = width - 2;
+                if (x > 0) gw = x - 1; else gw = 1;
+
+                if (mask[y * width + x] == GREENPOSITION && y % 2 == cy)
+                    oc[y * width + x] = (oc[y * width + ge]
+                                         + oc[y * width + gw]) / 2.0;
+                else if (mask[y * width + x] == GREENPOSITION
+                         && x % 2 == cx)
+                    oc[y * width + x] = (oc[gn * width + x]
+                                         + oc[gs * width + x]) / 2.0;
+                else
+                    oc[y * width + x] = (oc[gn * width + ge]
+                                         + oc[gn * width + gw]
+                                         + oc[gs * width + ge]
+                                         + oc[gs * width + gw]) / 4.0;
+            }
+}
+
+
+/**
+ * @brief reference demosaicking_bilinear_red_blue
+ */
+static void reference_bilinear_red_blue(int redx, int redy, float *ored,
+                                        float *ogreen, float *oblue,
+                                        int width, int height)
+{
+    unsigned char *mask = reference_mask(redx, redy, width, height);
+
+    for (int i = 0; i < width * height; i++)
+    {
+        ored[i] -= ogreen[i];
+        oblue[i] -= ogreen[i];
+    }
+
+    reference_difference(oblue, mask, BLUEPOSITION, 1 - redx, 1 - redy,
+                         width, height);
+    reference_difference(ored, mask, REDPOSITION, redx, redy,
+                         width, height);
+
+    for (int i = 0; i < width * height; i++)
+    {
+        ored[i] += ogreen[i];
+        oblue[i] += ogreen[i];
+    }
+
+    free(mask);
+}
+
+
+/**
+ * @brief reference demosaicking_adams
+ */
+static void reference_adams(float threshold, int redx, int redy,
+                            float *ired, float *igreen, float *iblue,
+                            float *ored, float *ogreen, float *oblue,
+                            int width, int height)
+{
+    unsigned char *mask = reference_mask(redx, redy, width, height);
+
+    wxCopy(ired, ored, width * height);
+    wxCopy(igreen, ogreen, width * height);
+    wxCopy(iblue, oblue, width * height);
+
+    for (int x = 0; x < width; x++)
+        for (int y = 0; y < height; y++)
+            if (mask[y * width + x] != GREENPOSITION
+                && (x < 3 || y < 3 || x >= width - 3 || y >= height - 3))
+            {
+                int gn, gs, ge, gw;
+
+                if (y > 0) gn = y - 1; else gn = 1;
+                if (y < height - 1) gs = y + 1; else gs = height - 2;
+                if (x < width - 1) ge = x + 1; else ge = width - 2;
+                if (x > 0) gw = x - 1; else gw = 1;
+
+                ogreen[y * width + x] = (ogreen[gn * width + x]
+                                         + ogreen[gs * width + x]
+                                         + ogreen[y * width + gw]
+                                         + ogreen[y * width + ge]) / 4.0;
+            }
+
+    for (int x = 3; x < width - 3; x++)
+        for (int y = 3; y < height - 3; y++)
+            if (mask[y * width + x] != GREENPOSITION)
+            {
+                int l = y * width + x;
+                int lp1 = (y + 1) * width + x;
+                int lp2 = (y + 2) * width + x;
+                int lm1 = (y - 1) * width + x;
+                int lm2 = (y - 2) * width + x;
+                float *orb = (mask[l] == BLUEPOSITION) ? oblue : ored;
+
+                float adv = fabsf(ogreen[lp1] - ogreen[lm1]);
+                float adh = fabsf(ogreen[l - 1] - ogreen[l + 1]);
+                float dh0 = 2.0 * orb[l] - orb[l + 2] - orb[l - 2];
+                float dv0 = 2.0 * orb[l] - orb[lp2] - orb[lm2];
+
+                adh = adh + fabsf(dh0);
+                adv = adv + fabsf(dv0);
+
+                if (fabsf(adv - adh) < threshold)
+                    ogreen[l] = (ogreen[lm1] + ogreen[lp1] + ogreen[l - 1]
+                                 + ogreen[l + 1]) / 4.0 + (dh0 + dv0) / 8.0;
+                else if (adh < adv)
+                    ogreen[l] = (ogreen[l - 1] + ogreen[l + 1]) / 2.0
+                        + (dh0) / 4.0;
+                else if (adv < adh)
+                    ogreen[l] = (ogreen[lp1] + ogreen[lm1]) / 2.0
+                        + (dv0) / 4.0;
+            }
+
+    reference_bilinear_red_blue(redx, redy, ored, ogreen, oblue,
+                                width, height);
+
+    free(mask);
+}
+
+
+/**
+ * @brief synthetic Bayer frame, smooth color gradients with some
+ * texture, the values of the missing channels are 0
+ */
+static void synthetic_cfa(float *data, int redx, int redy,
+                          int width, int height)
+{
+    int size = width * height;
+
+    srand(1);
+
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+        {
+            int l = y * width + x;
+            float texture = (float) (rand() % 32);
+            int position;
+
+            if (x % 2 == redx && y % 2 == redy)
+                position = REDPOSITION;
+            else if (x % 2 != redx && y % 2 != redy)
+                position = BLUEPOSITION;
+            else
+                position = GREENPOSITION;
+
+            data[l] = data[size + l] = data[2 * size + l] = 0.0;
+
+            if (position == REDPOSITION)
+                data[l] = (float) (x % 256) * 0.75 + texture;
+            else if (position == GREENPOSITION)
+                data[size + l] = (float) (y % 256) * 0.75 + texture;
+            else
+                data[2 * size + l] = (float) ((x + y) % 256) * 0.75 + texture;
+        }
+}
+
+
+/**
+ * @brief maximum absolute difference of two arrays
+ */
+static float max_difference(float *a, float *b, int size)
+{
+    float maxdiff = 0.0;
+
+    for (int i = 0; i < size; i++)
+        if (fabsf(a[i] - b[i]) > maxdiff)
+            maxdiff = fabsf(a[i] - b[i]);
+
+    return maxdiff;
+}
+
+
+/**
+ * @brief elapsed time in ms since start
+ */
+static double elapsed_ms(clock_t start)
+{
+    return 1000.0 * (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+
+/**
+ * @brief main function call
+ */
+int main(int argc, char **argv)
+{
+    int sizes[2][2] = {{3840, 2160}, {7680, 4320}};
+    const char *names[2] = {"4K", "8K"};
+    float threshold = 2.0;
+    int runs = 3;
+
+    /* version info */
+    if (2 <= argc && 0 == strcmp("-v", argv[1]))
+    {
+        fprintf(stdout, "%s version " __DATE__ "\n", argv[0]);
+        return EXIT_SUCCESS;
+    }
+    /* sanity check */
+    if (2 < argc)
+    {
+        fprintf(stderr, "usage : %s [runs]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (2 == argc && 0 >= (runs = atoi(argv[1])))
+    {
+        fprintf(stderr, "the number of runs must be positive\n");
+        return EXIT_FAILURE;
+    }
+
+    fprintf(stdout, "best of %d runs, RGGB, times in ms\n\n", runs);
+    fprintf(stdout, "frame  kernel          reference    current  speedup"
+            "  max diff\n");
+
+    for (int k = 0; k < 2; k++)
+    {
+        int width = sizes[k][0], height = sizes[k][1];
+        int size = width * height;
+        float *in, *ref, *out;
+
+        if (NULL == (in = (float *) malloc(3 * size * sizeof(float)))
+            || NULL == (ref = (float *) malloc(3 * size * sizeof(float)))
+            || NULL == (out = (float *) malloc(3 * size * sizeof(float))))
+        {
+            fprintf(stderr, "allocation error. not enough memory?\n");
+            return EXIT_FAILURE;
+        }
+
+        synthetic_cfa(in, 0, 0, width, height);
+
+        /* kernel 0 is the Adams-Hamilton demosaicking, kernel 1 the
+         * bilinear red and blue on the Adams-Hamilton green */
+        for (int kernel = 0; kernel < 2; kernel++)
+        {
+            double tref = 0.0, tout = 0.0;
+
+            for (int r = 0; r < runs; r++)
+            {
+                clock_t start;
+                double t;
+
+                if (0 == kernel)
+                {
+                    start = clock();
+                    reference_adams(threshold, 0, 0, in, in + size,
+                                    in + 2 * size, ref, ref + size,
+                                    ref + 2 * size, width, height);
+                    t = elapsed_ms(start);
+                    tref = (0 == r || t < tref) ? t : tref;
+
+                    start = clock();
+                    demosaicking_adams(threshold, 0, 0, in, in + size,
+                                       in + 2 * size, out, out + size,
+                                       out + 2 * size, width, height);
+                    t = elapsed_ms(start);
+                    tout = (0 == r || t < tout) ? t : tout;
+                }
+                else
+                {
+                    /* the CFA red and blue with the green of the
+                     * previous kernel */
+                    wxCopy(in, ref, size);
+                    wxCopy(in + 2 * size, ref + 2 * size, size);
+                    wxCopy(in, out, size);
+                    wxCopy(in + 2 * size, out + 2 * size, size);
+
+                    start = clock();
+                    reference_bilinear_red_blue(0, 0, ref, ref + size,
+                                                ref + 2 * size,
+                                                width, height);
+                    t = elapsed_ms(start);
+                    tref = (0 == r || t < tref) ? t : tref;
+
+                    start = clock();
+                    demosaicking_bilinear_red_blue(0, 0, out, out + size,
+                                                   out + 2 * size,
+                                                   width, height);
+                    t = elapsed_ms(start);
+                    tout = (0 == r || t < tout) ? t : tout;
+                }
+            }
+
+            fprintf(stdout, "%-5s  %-14s %10.1f %10.1f %7.2fx  %g\n",
+                    names[k], (0 == kernel) ? "adams" : "bilinear_rb",
+                    tref, tout, tref / tout,
+                    max_difference(ref, out, 3 * size));
+        }
+
+        free(in);
+        free(ref);
+        free(out);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -81,7 +81,8 @@ int main(int argc, char **argv)
 	
     unsigned char redx, redy;
     char *pattern_str = argv[3];
-    size_t nx = 0, ny = 0;
+    size_t nx = 0, ny = 0, nc = 0;
+    int bits = 8;
     float *data_in, *data_out;
     float *out_ptr, *end_ptr;
 	
@@ -127,13 +128,57 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 	
-    /* TIFF RGBA 8bit->float input */
-    if (NULL == (data_in = read_tiff_rgba_f32(argv[1], &nx, &ny)))
+    /*
+     * TIFF 8bit, 16bit or float->float input, streamed into planar
+     * arrays, other TIFF files and grayscale with alpha through the
+     * RGBA 8bit reader
+     */
+    data_in = read_tiff_f32(argv[1], &nx, &ny, &nc, &bits);
+    if (NULL != data_in && 2 == nc)
     {
-        fprintf(stderr, "error while reading from %s\n", argv[1]);
-        return EXIT_FAILURE;
+        free(data_in);
+        data_in = NULL;
+    }
+    if (NULL == data_in)
+    {
+        if (NULL == (data_in = read_tiff_rgba_f32(argv[1], &nx, &ny)))
+        {
+            fprintf(stderr, "error while reading from %s\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+        nc = 4;
+        bits = 8;
+    }
+	
+    /*
+     * a single channel is a raw CFA image, its samples are spread on
+     * the three color channels following the pattern
+     */
+    if (1 == nc)
+    {
+        float *data_cfa = data_in;
+		
+        if (NULL == (data_in = (float *) calloc(nx * ny * 3, sizeof(float))))
+        {
+            fprintf(stderr, "allocation error. not enough memory?\n");
+            free(data_cfa);
+            return EXIT_FAILURE;
+        }
+		
+        for (size_t y = 0; y < ny; y++)
+            for (size_t x = 0; x < nx; x++)
+            {
+                size_t c = (x % 2 == redx && y % 2 == redy) ? 0 :
+                    ((x % 2 != redx && y % 2 != redy) ? 2 : 1);
+				
+                data_in[c * nx * ny + y * nx + x] = data_cfa[y * nx + x];
+            }
+		
+        free(data_cfa);
+        nc = 3;
     }
-    if (NULL == (data_out = (float *) malloc(sizeof(float) * nx * ny * 4)))
+	
+    if (NULL == (data_out = (float *) malloc(sizeof(float) * nx * ny * nc)))
     {
         fprintf(stderr, "allocation error. not enough memory?\n");
 		free(data_in);
@@ -160,12 +205,19 @@ int main(int argc, char **argv)
 		out_ptr++;
     }
 	
-    /* copy alpha channel */
-    memcpy(data_out + 3 * nx * ny, data_in + 3 * nx * ny,
-		   nx * ny * sizeof(float));
+    /* copy the alpha and extra channels */
+    if (3 < nc)
+        memcpy(data_out + 3 * nx * ny, data_in + 3 * nx * ny,
+               (nc - 3) * nx * ny * sizeof(float));
 	
-    /* TIFF RGBA float->8bit output */
-    write_tiff_rgba_f32(argv[2], data_out, nx, ny);
+    /* TIFF float->8bit, 16bit or float output, in the input bit depth */
+    if (0 != write_tiff_f32(argv[2], data_out, nx, ny, nc, bits, 0))
+    {
+        fprintf(stderr, "error while writing to %s\n", argv[2]);
+        free(data_in);
+        free(data_out);
+        return EXIT_FAILURE;
+    }
 	
     free(data_in);
     free(data_out);
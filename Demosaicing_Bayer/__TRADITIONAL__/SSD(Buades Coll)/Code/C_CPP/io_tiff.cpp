@@ -406,4 +406,463 @@ int write_tiff_rgba_u8(const char *fname, const unsigned char *data,
     return write_tiff_rgba(fname, (void *) data, nx, ny, DT_U8);
 }
 
+/*
+ * STREAMING FUNCTIONS
+ */
+
+/**
+ * @brief scale of the samples, mapped to [0,255] so that the
+ * parameters of the 8bit algorithms apply, float samples are taken in
+ * [0,1]
+ */
+static float sample_scale(int bits)
+{
+    return (16 == bits) ? 255. / 65535. : ((32 == bits) ? 255. : 1.);
+}
+
+/**
+ * @brief convert n interleaved pixels of a strip or tile to planar floats
+ *
+ * The buffer holds pixels of nsamples interleaved samples, they are
+ * written to the channels c0 to c0 + nsamples - 1 of the planar array
+ * data, whose planes have plane floats, from the pixel offset on.
+ *
+ * @param buf the samples, in native byte order as given by libtiff
+ * @param bits the bits per sample : 8, 16 (unsigned integers) or 32
+ * (IEEE float)
+ */
+static void unpack_samples(const void *buf, int bits, size_t n,
+                           size_t nsamples, size_t c0, float *data,
+                           size_t plane, size_t offset)
+{
+    float scale = sample_scale(bits);
+    size_t i, k;
+
+    for (k = 0; k < nsamples; k++)
+    {
+        float *ptr_out = data + (c0 + k) * plane + offset;
+
+        switch (bits)
+        {
+        case 8:
+        {
+            const uint8 *ptr_in = (const uint8 *) buf + k;
+            for (i = 0; i < n; i++)
+                ptr_out[i] = (float) ptr_in[i * nsamples];
+            break;
+        }
+        case 16:
+        {
+            const uint16 *ptr_in = (const uint16 *) buf + k;
+            for (i = 0; i < n; i++)
+                ptr_out[i] = scale * (float) ptr_in[i * nsamples];
+            break;
+        }
+        default:
+        {
+            const float *ptr_in = (const float *) buf + k;
+            for (i = 0; i < n; i++)
+                ptr_out[i] = scale * ptr_in[i * nsamples];
+            break;
+        }
+        }
+    }
+}
+
+/**
+ * @brief convert n pixels of planar floats to interleaved samples
+ *
+ * The reverse of unpack_samples, the integer samples are rounded and
+ * clipped, the float samples are only scaled.
+ */
+static void pack_samples(void *buf, int bits, size_t n, size_t nsamples,
+                         const float *data, size_t plane, size_t offset)
+{
+    float scale = 1. / sample_scale(bits);
+    float vmax = (8 == bits) ? 255. : 65535.;
+    size_t i, k;
+
+    for (k = 0; k < nsamples; k++)
+    {
+        const float *ptr_in = data + k * plane + offset;
+
+        for (i = 0; i < n; i++)
+        {
+            float value = ptr_in[i];
+
+            if (32 == bits)
+            {
+                ((float *) buf)[i * nsamples + k] = value * scale;
+                continue;
+            }
+
+            value = value * scale + .5;
+            value = (value < 0.) ? 0. : ((value > vmax) ? vmax : value);
+
+            if (8 == bits)
+                ((uint8 *) buf)[i * nsamples + k] = (uint8) value;
+            else
+                ((uint16 *) buf)[i * nsamples + k] = (uint16) value;
+        }
+    }
+}
+
+/**
+ * @brief bring planar float arrays read in a TIFF orientation to the
+ * top-left one
+ *
+ * The orientations 2 to 4 are mirrors of the rows and/or the columns,
+ * they are reversed in place. The transposed orientations 5 to 8 are
+ * not handled.
+ *
+ * @return 0 if OK, != 0 if the orientation is not handled
+ */
+static int orient_topleft(float *data, size_t nx, size_t ny, size_t nc,
+                          uint16 orientation)
+{
+    int flipx = (ORIENTATION_TOPRIGHT == orientation
+                 || ORIENTATION_BOTRIGHT == orientation);
+    int flipy = (ORIENTATION_BOTRIGHT == orientation
+                 || ORIENTATION_BOTLEFT == orientation);
+    size_t c, x, y;
+
+    if (ORIENTATION_TOPLEFT != orientation && !flipx && !flipy)
+        return -1;
+
+    for (c = 0; c < nc; c++)
+    {
+        float *ptr = data + c * nx * ny;
+
+        /* reverse the order of the rows */
+        if (flipy)
+            for (y = 0; y < ny / 2; y++)
+                for (x = 0; x < nx; x++)
+                {
+                    float tmp = ptr[y * nx + x];
+                    ptr[y * nx + x] = ptr[(ny - 1 - y) * nx + x];
+                    ptr[(ny - 1 - y) * nx + x] = tmp;
+                }
+
+        /* reverse each row */
+        if (flipx)
+            for (y = 0; y < ny; y++)
+                for (x = 0; x < nx / 2; x++)
+                {
+                    float tmp = ptr[y * nx + x];
+                    ptr[y * nx + x] = ptr[y * nx + nx - 1 - x];
+                    ptr[y * nx + nx - 1 - x] = tmp;
+                }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief load a TIFF image file as planar float arrays, strip by strip
+ * or tile by tile
+ *
+ * The array is allocated by this function. It holds the nc channels
+ * of the image as nc contiguous arrays : 1 for a grayscale or CFA
+ * image, 3 for RGB, more with extra samples such as alpha. The strips
+ * or tiles are decoded one at a time straight into the planar arrays,
+ * contiguous and separate planar configurations are both handled.
+ *
+ * 8bit and 16bit unsigned integer samples are mapped to [0,255], the
+ * 16bit precision is kept in the fractional part. 32bit IEEE float
+ * samples are taken in [0,1] and mapped to [0,255] as well, values out
+ * of [0,1] are kept.
+ *
+ * The rows are returned top-left first, as with read_tiff_rgba_f32(),
+ * whatever the orientation of the file, except for the transposed
+ * orientations.
+ *
+ * @param fname the file name to read
+ * @param nx, ny, nc storage space for the image size and the number of
+ * channels
+ * @param bits storage space for the bits per sample of the file, may be
+ * NULL
+ *
+ * @return the data array pointer, NULL if an error occured or if the
+ * sample format is not supported (palette images, other bit depths,
+ * transposed orientations), such files may still be read by
+ * read_tiff_rgba_f32()
+ */
+float *read_tiff_f32(const char *fname, size_t * nx, size_t * ny,
+                     size_t * nc, int *bits)
+{
+    TIFF *tiffp = NULL;
+    uint32 width = 0, height = 0;
+    uint16 bitspersample = 0, samplesperpixel = 0, sampleformat = 0;
+    uint16 planarconfig = 0, photometric = 0, orientation = 0;
+    tdata_t buf = NULL;
+    float *data = NULL;
+    size_t plane, nsamples, nplanes, s;
+
+    /* no warning messages */
+    (void) TIFFSetWarningHandler(NULL);
 
+    /* open the TIFF file and structure */
+    if (NULL == (tiffp = TIFFOpen(fname, "r")))
+        return NULL;
+
+    /* read the image structure and check it is supported */
+    if (1 != TIFFGetField(tiffp, TIFFTAG_IMAGEWIDTH, &width)
+        || 1 != TIFFGetField(tiffp, TIFFTAG_IMAGELENGTH, &height)
+        || 1 != TIFFGetFieldDefaulted(tiffp, TIFFTAG_BITSPERSAMPLE,
+                                      &bitspersample)
+        || 1 != TIFFGetFieldDefaulted(tiffp, TIFFTAG_SAMPLESPERPIXEL,
+                                      &samplesperpixel)
+        || 1 != TIFFGetFieldDefaulted(tiffp, TIFFTAG_SAMPLEFORMAT,
+                                      &sampleformat)
+        || 1 != TIFFGetFieldDefaulted(tiffp, TIFFTAG_PLANARCONFIG,
+                                      &planarconfig)
+        || 1 != TIFFGetFieldDefaulted(tiffp, TIFFTAG_ORIENTATION,
+                                      &orientation)
+        || 1 != TIFFGetField(tiffp, TIFFTAG_PHOTOMETRIC, &photometric)
+        || (PHOTOMETRIC_MINISBLACK != photometric
+            && PHOTOMETRIC_RGB != photometric)
+        || !(((8 == bitspersample || 16 == bitspersample)
+              && SAMPLEFORMAT_UINT == sampleformat)
+             || (32 == bitspersample
+                 && SAMPLEFORMAT_IEEEFP == sampleformat)))
+    {
+        TIFFClose(tiffp);
+        return NULL;
+    }
+
+    plane = (size_t) width * (size_t) height;
+
+    /*
+     * with the contiguous configuration, each strip or tile holds all
+     * the samples of its pixels, with the separate one it holds one
+     * sample and there is a plane of strips or tiles per sample
+     */
+    if (PLANARCONFIG_SEPARATE == planarconfig)
+    {
+        nsamples = 1;
+        nplanes = samplesperpixel;
+    }
+    else
+    {
+        nsamples = samplesperpixel;
+        nplanes = 1;
+    }
+
+    /* allocate the planar array and the strip or tile buffer */
+    if (NULL == (data = (float *) malloc(samplesperpixel * plane
+                                         * sizeof(float)))
+        || NULL == (buf = _TIFFmalloc(TIFFIsTiled(tiffp) ?
+                                      TIFFTileSize(tiffp) :
+                                      TIFFStripSize(tiffp))))
+        goto error;
+
+    if (TIFFIsTiled(tiffp))
+    {
+        uint32 tilewidth = 0, tilelength = 0, x, y, j;
+
+        if (1 != TIFFGetField(tiffp, TIFFTAG_TILEWIDTH, &tilewidth)
+            || 1 != TIFFGetField(tiffp, TIFFTAG_TILELENGTH, &tilelength))
+            goto error;
+
+        /* decode each tile and copy its rows inside the image */
+        for (s = 0; s < nplanes; s++)
+            for (y = 0; y < height; y += tilelength)
+                for (x = 0; x < width; x += tilewidth)
+                {
+                    uint32 w = (x + tilewidth > width) ? width - x : tilewidth;
+                    uint32 h = (y + tilelength > height) ?
+                        height - y : tilelength;
+
+                    if (0 > TIFFReadTile(tiffp, buf, x, y, 0, (tsample_t) s))
+                        goto error;
+
+                    for (j = 0; j < h; j++)
+                        unpack_samples((const uint8 *) buf + (size_t) j
+                                       * tilewidth * nsamples
+                                       * (bitspersample / 8),
+                                       bitspersample, w, nsamples, s, data,
+                                       plane, (size_t) (y + j) * width + x);
+                }
+    }
+    else
+    {
+        uint32 rowsperstrip = 0, y;
+
+        (void) TIFFGetFieldDefaulted(tiffp, TIFFTAG_ROWSPERSTRIP,
+                                     &rowsperstrip);
+        if (rowsperstrip > height || 0 == rowsperstrip)
+            rowsperstrip = height;
+
+        /* decode each strip, its rows are contiguous in the planes */
+        for (s = 0; s < nplanes; s++)
+            for (y = 0; y < height; y += rowsperstrip)
+            {
+                uint32 h = (y + rowsperstrip > height) ?
+                    height - y : rowsperstrip;
+
+                if (0 > TIFFReadEncodedStrip(tiffp,
+                                             TIFFComputeStrip(tiffp, y,
+                                                              (tsample_t) s),
+                                             buf, (tsize_t) -1))
+                    goto error;
+
+                unpack_samples(buf, bitspersample, (size_t) h * width,
+                               nsamples, s, data, plane, (size_t) y * width);
+            }
+    }
+
+    _TIFFfree(buf);
+    buf = NULL;
+
+    /* the rows and columns in the top-left orientation */
+    if (0 != orient_topleft(data, width, height, samplesperpixel,
+                            orientation))
+        goto error;
+
+    TIFFClose(tiffp);
+
+    *nx = (size_t) width;
+    *ny = (size_t) height;
+    *nc = (size_t) samplesperpixel;
+    if (NULL != bits)
+        *bits = bitspersample;
+
+    return data;
+
+  error:
+    if (NULL != buf)
+        _TIFFfree(buf);
+    free(data);
+    TIFFClose(tiffp);
+    return NULL;
+}
+
+/**
+ * @brief save planar float arrays into a LZW-compressed TIFF file, strip
+ * by strip or tile by tile
+ *
+ * The nc contiguous arrays of data are written as the channels of a
+ * grayscale (nc = 1 or 2) or RGB (nc >= 3) image, the channels after
+ * the color ones are associated alpha. The samples are interleaved and
+ * encoded one strip or tile at a time.
+ *
+ * @param fname TIFF file name
+ * @param data input array of float values in [0,255], 16bit samples
+ * are mapped to [0,65535] and 32bit float samples to [0,1]
+ * @param nx, ny, nc array size and number of channels
+ * @param bits bits per sample of the file : 8, 16 (unsigned integers)
+ * or 32 (IEEE float)
+ * @param tile size of the square tiles, a multiple of 16, 0 to write
+ * strips of the default size
+ *
+ * @return 0 if OK, != 0 if an error occured
+ */
+int write_tiff_f32(const char *fname, const float *data, size_t nx,
+                   size_t ny, size_t nc, int bits, size_t tile)
+{
+    TIFF *tiffp = NULL;
+    uint16 extra_type[] = { EXTRASAMPLE_ASSOCALPHA, EXTRASAMPLE_ASSOCALPHA,
+        EXTRASAMPLE_ASSOCALPHA, EXTRASAMPLE_ASSOCALPHA };
+    uint16 ncolors = (nc >= 3) ? 3 : 1;
+    tdata_t buf = NULL;
+    size_t plane = nx * ny;
+    size_t x, y;
+
+    /* check the data, the sizes and the bit depth */
+    if (NULL == data || 0 == nc || nc > ncolors + 4u
+        || 4294967295. < (double) nx || 4294967295. < (double) ny
+        || (8 != bits && 16 != bits && 32 != bits) || 0 != tile % 16)
+        return -1;
+
+    /* no warning messages */
+    (void) TIFFSetWarningHandler(NULL);
+
+    /* open the TIFF file and structure */
+    if (NULL == (tiffp = TIFFOpen(fname, "w")))
+        return -1;
+
+    /* insert tags into the TIFF structure */
+    if (1 != TIFFSetField(tiffp, TIFFTAG_IMAGEWIDTH, (uint32) nx)
+        || 1 != TIFFSetField(tiffp, TIFFTAG_IMAGELENGTH, (uint32) ny)
+        || 1 != TIFFSetField(tiffp, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT)
+        || 1 != TIFFSetField(tiffp, TIFFTAG_BITSPERSAMPLE, (uint16) bits)
+        || 1 != TIFFSetField(tiffp, TIFFTAG_SAMPLEFORMAT, (32 == bits) ?
+                             SAMPLEFORMAT_IEEEFP : SAMPLEFORMAT_UINT)
+        || 1 != TIFFSetField(tiffp, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG)
+        || 1 != TIFFSetField(tiffp, TIFFTAG_SAMPLESPERPIXEL, (uint16) nc)
+        || 1 != TIFFSetField(tiffp, TIFFTAG_PHOTOMETRIC, (3 == ncolors) ?
+                             PHOTOMETRIC_RGB : PHOTOMETRIC_MINISBLACK)
+        || 1 != TIFFSetField(tiffp, TIFFTAG_COMPRESSION, COMPRESSION_LZW)
+        || (nc > ncolors
+            && 1 != TIFFSetField(tiffp, TIFFTAG_EXTRASAMPLES,
+                                 (uint16) (nc - ncolors), extra_type)))
+    {
+        TIFFClose(tiffp);
+        return -1;
+    }
+
+    if (0 != tile)
+    {
+        /* square tiles, the tiles on the right and bottom are padded */
+        if (1 != TIFFSetField(tiffp, TIFFTAG_TILEWIDTH, (uint32) tile)
+            || 1 != TIFFSetField(tiffp, TIFFTAG_TILELENGTH, (uint32) tile)
+            || NULL == (buf = _TIFFmalloc(TIFFTileSize(tiffp))))
+            goto error;
+
+        for (y = 0; y < ny; y += tile)
+            for (x = 0; x < nx; x += tile)
+            {
+                size_t w = (x + tile > nx) ? nx - x : tile;
+                size_t h = (y + tile > ny) ? ny - y : tile;
+                size_t j;
+
+                _TIFFmemset(buf, 0, TIFFTileSize(tiffp));
+
+                for (j = 0; j < h; j++)
+                    pack_samples((uint8 *) buf + j * tile * nc * (bits / 8),
+                                 bits, w, nc, data, plane, (y + j) * nx + x);
+
+                if (0 > TIFFWriteEncodedTile(tiffp,
+                                             TIFFComputeTile(tiffp,
+                                                             (uint32) x,
+                                                             (uint32) y, 0,
+                                                             0),
+                                             buf, TIFFTileSize(tiffp)))
+                    goto error;
+            }
+    }
+    else
+    {
+        /* strips of the default size of libtiff, about 8kB */
+        uint32 rowsperstrip = TIFFDefaultStripSize(tiffp, 0);
+
+        if (1 != TIFFSetField(tiffp, TIFFTAG_ROWSPERSTRIP, rowsperstrip)
+            || NULL == (buf = _TIFFmalloc(TIFFStripSize(tiffp))))
+            goto error;
+
+        for (y = 0; y < ny; y += rowsperstrip)
+        {
+            size_t h = (y + rowsperstrip > ny) ? ny - y : rowsperstrip;
+
+            pack_samples(buf, bits, h * nx, nc, data, plane, y * nx);
+
+            if (0 > TIFFWriteEncodedStrip(tiffp,
+                                          TIFFComputeStrip(tiffp,
+                                                           (uint32) y, 0),
+                                          buf, (tsize_t) (h * nx * nc
+                                                          * (bits / 8))))
+                goto error;
+        }
+    }
+
+    /* free the TIFF structure and data, return success */
+    _TIFFfree(buf);
+    TIFFClose(tiffp);
+    return 0;
+
+  error:
+    if (NULL != buf)
+        _TIFFfree(buf);
+    TIFFClose(tiffp);
+    return -1;
+}
@@ -25,10 +25,14 @@
  *
  * @todo stdin/stdout handling
  * @todo simple RGB/grayscale version
- * @todo TIFF float version
  *
- * These routines focus on RGBA 8bit TIFF files. These files can be
+ * The RGBA routines focus on RGBA 8bit TIFF files. These files can be
  * read into or written from unsigned char or float arrays.
+ *
+ * read_tiff_f32() and write_tiff_f32() handle 8bit and 16bit integer
+ * and 32bit float samples, with one (CFA or grayscale) or more
+ * channels, as planar float arrays. They decode and encode one strip
+ * or tile at a time, without any RGBA intermediate.
  */
 
 #include <stdlib.h>
@@ -48,6 +52,8 @@ float *read_tiff_rgba_f32(const char *fname, size_t *nx, size_t *ny);
 unsigned char *read_tiff_rgba_u8(const char *fname, size_t *nx, size_t *ny);
 int write_tiff_rgba_f32(const char *fname, const float *data, size_t nx, size_t ny);
 int write_tiff_rgba_u8(const char *fname, const unsigned char *data, size_t nx, size_t ny);
+float *read_tiff_f32(const char *fname, size_t *nx, size_t *ny, size_t *nc, int *bits);
+int write_tiff_f32(const char *fname, const float *data, size_t nx, size_t ny, size_t nc, int bits, size_t tile);
 
 
 
@@ -219,71 +219,258 @@ float l2_distance_r1(float *u0, int i0, int j0, int i1,
 
 
 
+// Sort a pair of values, compare-exchange of the selection networks
+#define MEDIAN_SORT(a,b) { float fMin = MIN(a,b); float fMax = MAX(a,b); a = fMin; b = fMax; }
+
+
 /**
- * \brief  Sliding window iterated median filter
+ * \brief  Median of the 3x3 windows of the row y, for x in [x0, x1), written to vc
  *
+ * Selection network of 19 compare-exchanges (Paeth), without branches so that the loop on x is vectorized.
+ * The window must lie inside the image, whose rows from iu0 on are stored in u.
  *
- * @param[in]   u  input image
- * @param[out]  v  output image
- * @param[in]  inIter  number of iterations
- * @param[in]  fRadius window of size (2*fRadius+1) x (2*fRadius+1)
- * @param[in]  iWidth, iHeight size of the image
+ */
+
+static void median3x3_row(float *u, int iu0, float *vc, int y, int x0, int x1, int iWidth)
+{
+	
+	float *up = u + (y-1-iu0)*iWidth, *uc = u + (y-iu0)*iWidth, *un = u + (y+1-iu0)*iWidth;
+	
+	for(int x=x0; x < x1; x++) {
+		
+		float p0 = up[x-1], p1 = up[x], p2 = up[x+1];
+		float p3 = uc[x-1], p4 = uc[x], p5 = uc[x+1];
+		float p6 = un[x-1], p7 = un[x], p8 = un[x+1];
+		
+		MEDIAN_SORT(p1, p2); MEDIAN_SORT(p4, p5); MEDIAN_SORT(p7, p8);
+		MEDIAN_SORT(p0, p1); MEDIAN_SORT(p3, p4); MEDIAN_SORT(p6, p7);
+		MEDIAN_SORT(p1, p2); MEDIAN_SORT(p4, p5); MEDIAN_SORT(p7, p8);
+		MEDIAN_SORT(p0, p3); MEDIAN_SORT(p5, p8); MEDIAN_SORT(p4, p7);
+		MEDIAN_SORT(p3, p6); MEDIAN_SORT(p1, p4); MEDIAN_SORT(p2, p5);
+		MEDIAN_SORT(p4, p7); MEDIAN_SORT(p4, p2); MEDIAN_SORT(p6, p4);
+		MEDIAN_SORT(p4, p2);
+		
+		vc[x] = p4;
+		
+	}
+	
+}
+
+
+
+/**
+ * \brief  Replace the value vout of an ordered array of ilength values by vin, keeping it ordered
+ *
+ * The values between the two positions are shifted by one, as in an insertion sort.
  *
  */
 
+static void sorted_replace(float *arr, int ilength, float vout, float vin)
+{
+	
+	int k = 0;
+	while (arr[k] < vout) k++;
+	
+	if (vin > vout) {
+		
+		while (k+1 < ilength && arr[k+1] < vin) { arr[k] = arr[k+1]; k++; }
+		
+	} else {
+		
+		while (k > 0 && arr[k-1] > vin) { arr[k] = arr[k-1]; k--; }
+		
+	}
+	
+	arr[k] = vin;
+	
+}
 
 
 
-void wxMedian(float *u,float *v, float fRadius, int inIter, int iWidth,int iHeight)
+/**
+ * \brief  Insert a value in an ordered array of ilength values
+ */
+
+static void sorted_insert(float *arr, int &ilength, float value)
+{
+	
+	int k = ilength++;
+	while (k > 0 && arr[k-1] > value) { arr[k] = arr[k-1]; k--; }
+	
+	arr[k] = value;
+	
+}
+
+
+
+/**
+ * \brief  Remove a value from an ordered array of ilength values
+ */
+
+static void sorted_remove(float *arr, int &ilength, float value)
+{
+	
+	int k = 0;
+	while (arr[k] < value) k++;
+	
+	for(ilength--; k < ilength; k++) arr[k] = arr[k+1];
+	
+}
+
+
+
+/**
+ * \brief  Median of the windows of the row y, for x in [x0, x1), written to vc
+ *
+ * The values of the window are kept ordered while the window slides along the row: at each step the value leaving 
+ * each row of the window is replaced by the entering one, moved to its ordered position.  The window is clipped to 
+ * the image, whose rows from iu0 on are stored in u.  iHalfWidth[j] is the half width of the row y+j-iRadius of the 
+ * window, -1 if the row is empty.
+ *
+ */
+
+static void median_sliding_row(float *u, int iu0, float *vc, int y, int x0, int x1, int iRadius, int *iHalfWidth, float *vector, int iWidth, int iHeight)
+{
+	
+	// Window of the pixel x0
+	int iCount = 0;
+	for(int j=-iRadius; j <= iRadius; j++) {
+		
+		int y0 = y + j, w = iHalfWidth[j + iRadius];
+		if (y0 < 0 || y0 >= iHeight || w < 0) continue;
+		
+		for(int x=MAX(0, x0-w); x <= MIN(iWidth-1, x0+w); x++)
+			vector[iCount++] = u[(y0-iu0)*iWidth+x];
+		
+	}
+	
+	QuickSortFloat(vector, iCount);
+	vc[x0] = vector[iCount / 2];
+	
+	
+	// Slide the window
+	for(int x=x0+1; x < x1; x++) {
+		
+		for(int j=-iRadius; j <= iRadius; j++) {
+			
+			int y0 = y + j, w = iHalfWidth[j + iRadius];
+			if (y0 < 0 || y0 >= iHeight || w < 0) continue;
+			
+			float *ur = u + (y0-iu0)*iWidth;
+			int xout = x-1-w, xin = x+w;
+			
+			if (xout >= 0 && xin < iWidth) sorted_replace(vector, iCount, ur[xout], ur[xin]);
+			else if (xout >= 0) sorted_remove(vector, iCount, ur[xout]);
+			else if (xin < iWidth) sorted_insert(vector, iCount, ur[xin]);
+			
+		}
+		
+		vc[x] = vector[iCount / 2];
+		
+	}
+	
+}
+
+
+
+/**
+ * \brief  Median filter of the rows [iy0, iy1) of an image
+ *
+ * The window is the disk of radius fRadius.  When it is the 3x3 square (2 <= fRadius^2 < 4, as fRadius = 1.5 of 
+ * chromatic_median) the interior pixels use a selection network, the others and larger windows an ordered window 
+ * updated incrementally along each row.  The output is the same as ordering the values of each window.
+ *
+ * Only the rows of the image needed by the windows have to be stored, so that bands of rows are filtered in cache.
+ *
+ *
+ * @param[in]   u  rows of the input image, from the row iu0 to the row MIN(iy1 + fRadius, iHeight-1) at least
+ * @param[in]   iu0  first row stored in u
+ * @param[out]  v  output rows, the row y is written at v + (y - iy0) * iWidth
+ * @param[in]  fRadius window of size (2*fRadius+1) x (2*fRadius+1)
+ * @param[in]  iy0, iy1  rows to filter
+ * @param[in]  iWidth, iHeight size of the image
+ *
+ */
+
+void wxMedianRows(float *u, int iu0, float *v, float fRadius, int iy0, int iy1, int iWidth, int iHeight)
 {
-    
 	
 	int iRadius = (int)(fRadius+1.0);
 	int iNeigSize = (2*iRadius+1)*(2*iRadius+1);
 	float fRadiusSqr = fRadius * fRadius;
 	
 	
+	// Half width of each row of the window, -1 if empty
+	int *iHalfWidth = new int[2*iRadius+1];
+	
+	for(int j=-iRadius;j<=iRadius;j++) {
+		
+		iHalfWidth[j+iRadius] = -1;
+		for(int i=0;i<=iRadius;i++)
+			if ((float) (i*i + j*j) <= fRadiusSqr) iHalfWidth[j+iRadius] = i;
+		
+	}
+	
+	int i3x3 = (fRadiusSqr >= 2.0f && fRadiusSqr < 4.0f);
+	
+	
 	// Vector to store values of each pixel neighborhood
 	float * vector = new float[iNeigSize];
 	
+	// For each row
+	for(int y=iy0; y < iy1; y++) {
+		
+		float *vc = v + (y-iy0)*iWidth;
+		
+		if (i3x3 && y > 0 && y < iHeight-1 && iWidth > 2) {
+			
+			median3x3_row(u, iu0, vc, y, 1, iWidth-1, iWidth);
+			
+			median_sliding_row(u, iu0, vc, y, 0, 1, iRadius, iHalfWidth, vector, iWidth, iHeight);
+			median_sliding_row(u, iu0, vc, y, iWidth-1, iWidth, iRadius, iHalfWidth, vector, iWidth, iHeight);
+			
+		} else
+			median_sliding_row(u, iu0, vc, y, 0, iWidth, iRadius, iHalfWidth, vector, iWidth, iHeight);
+		
+	}
+	
+	delete[] vector;
+	delete[] iHalfWidth;
+	
+}
+
+
+
+/**
+ * \brief  Sliding window iterated median filter
+ *
+ * Each iteration is a wxMedianRows of the whole image.
+ *
+ *
+ * @param[in]   u  input image
+ * @param[out]  v  output image
+ * @param[in]  inIter  number of iterations
+ * @param[in]  fRadius window of size (2*fRadius+1) x (2*fRadius+1)
+ * @param[in]  iWidth, iHeight size of the image
+ *
+ */
+
+
+
+
+void wxMedian(float *u,float *v, float fRadius, int inIter, int iWidth,int iHeight)
+{
+    
+	
 	// For each iteration
 	for(int n = 0;  n < inIter; n++){
 		
-		// For each pixel
-		for(int x=0;x < iWidth;x++)
-			for(int y=0;y< iHeight;y++){
-				
-				// Take spatial neighborhood fo radius fRadius
-				int iCount=0;
-				for(int i=-iRadius;i<=iRadius;i++)
-					for(int j=-iRadius;j<=iRadius;j++)
-						if ((float) (i*i + j*j) <= fRadiusSqr){
-							
-							int x0=x+i;
-							int y0=y+j;
-							
-							if (x0 >= 0 && y0 >= 0 && x0 < iWidth && y0 < iHeight) { 
-								
-								vector[iCount] = u[y0*iWidth+x0];
-								iCount++; 
-								
-							}
-							
-						}
-				
-				// order neighborhood values
-				QuickSortFloat(vector, iCount);
-				
-				v[y*iWidth+x] = vector[iCount / 2];
-				
-			}
+		wxMedianRows(u, 0, v, fRadius, 0, iHeight, iWidth, iHeight);
 		
 		wxCopy(v,u,iWidth*iHeight);
 		
 	}
 	
-	delete[] vector;
-	
 }
 
 
@@ -155,6 +155,23 @@ float sLUT(float dif,float *lut);
 
 
 
+/**
+ * \brief  Median filter of the rows [iy0, iy1) of an image
+ *
+ *
+ * @param[in]   u  rows of the input image, from the row iu0 to the row MIN(iy1 + fRadius, iHeight-1) at least
+ * @param[in]   iu0  first row stored in u
+ * @param[out]  v  output rows, the row y is written at v + (y - iy0) * iWidth
+ * @param[in]  fRadius window of size (2*fRadius+1) x (2*fRadius+1)
+ * @param[in]  iy0, iy1  rows to filter
+ * @param[in]  iWidth, iHeight size of the image
+ *
+ */
+
+void wxMedianRows(float *u, int iu0, float *v, float fRadius, int iy0, int iy1, int iWidth, int iHeight);
+
+
+
 /**
  * \brief  Sliding window iterated median filter
  *
@@ -50,6 +50,50 @@
 #define REDPOSITION 1
 #define BLUEPOSITION 2
 
+// Number of rows and columns of the tiles processed in parallel by the NLmeans demosaicking
+#define NLMEANS_BAND 32
+#define NLMEANS_TILE_WIDTH 64
+
+// Number of rows of the bands of the chromatic median
+#define CHROMATIC_BAND 32
+
+
+
+
+/**
+ * \brief  Column parity of the red or blue pixels of row y, for the CFA phase with red pixel at (RedX, RedY)
+ */
+template<int RedX, int RedY>
+static inline int cfa_rb_column(int y)
+{
+	return ((y & 1) == RedY) ? RedX : 1 - RedX;
+}
+
+
+
+/**
+ * \brief  Color of the CFA at (x, y), for the CFA phase with red pixel at (RedX, RedY)
+ */
+template<int RedX, int RedY>
+static inline int cfa_position(int x, int y)
+{
+	if ((x & 1) != cfa_rb_column<RedX, RedY>(y)) return GREENPOSITION;
+	else if ((y & 1) == RedY) return REDPOSITION;
+	else return BLUEPOSITION;
+}
+
+
+
+/**
+ * \brief  North, south, east and west neighbours of (x, y) taking a mirror symmetry at the boundaries
+ */
+static inline void mirror_neighbours(int x, int y, int width, int height, int &gn, int &gs, int &ge, int &gw)
+{
+	if (y > 0)  gn = y-1;	else    gn = 1;
+	if (y < height-1)	gs = y+1;  else  gs = height - 2 ;
+	if (x < width-1)  ge = x+1;  else  ge = width-2;
+	if (x > 0) gw = x-1;	else  gw = 1;
+}
 
 
 
@@ -65,6 +109,111 @@
 
 
 
+/**
+ * \brief  Green of the red or blue pixel (x, y) near the boundaries: average of the four neighbouring green pixels
+ */
+static inline void adams_green_border(float *ogreen, int x, int y, int width, int height)
+{
+	int gn, gs, ge, gw;
+	
+	mirror_neighbours(x, y, width, height, gn, gs, ge, gw);
+	
+	ogreen[y*width + x] = (ogreen[gn*width + x] +  ogreen[gs*width + x] + ogreen[y*width + gw] +  ogreen[y*width + ge])/ 4.0;
+}
+
+
+
+
+/**
+ * \brief  Green channel of the Adams-Hamilton algorithm for the CFA phase with red pixel at (RedX, RedY)
+ *
+ * Red and blue pixels are visited row by row with stride 2, so the color of each pixel is known without any test.
+ *
+ */
+
+template<int RedX, int RedY>
+static void demosaicking_adams_green(float threshold, float *ored, float *ogreen, float *oblue, int width, int height)
+{
+	
+	// Interpolate the green channel by bilinear on the boundaries  
+	// make the average of four neighbouring green pixels: Nourth, South, East, West
+	// Only the 3 first and last rows and columns are visited
+	for(int y=0;y<height;y++) {
+		
+		int x0 = cfa_rb_column<RedX, RedY>(y);
+		
+		if (y < 3 || y >= height - 3) {
+			
+			for(int x=x0;x<width;x+=2)  adams_green_border(ogreen, x, y, width, height);
+			
+		} else {
+			
+			// first x >= MAX(width-3, 3) of the parity of x0
+			int t = MAX(width-3, 3);
+			int x1 = t + ((t - x0) & 1);
+			
+			for(int x=x0;x<3 && x<width;x+=2)  adams_green_border(ogreen, x, y, width, height);
+			for(int x=x1;x<width;x+=2)  adams_green_border(ogreen, x, y, width, height);
+			
+		}
+		
+	}
+	
+	
+	
+	// Interpolate the green by Adams algorithm inside the image    
+	// First interpolate green directionally
+	for(int y=3;y<height-3;y++)
+	{
+		
+		// If the row has blue pixels, we compute the horizontal and vertical blue second derivatives
+		// else it has red pixels, we compute the horizontal and vertical red second derivatives
+		float *orb = ((y & 1) == RedY) ? ored : oblue;
+		
+		for(int x=4-cfa_rb_column<RedX, RedY>(y);x<width-3;x+=2) {  
+			
+			
+			int l = y*width+x;
+			int lp1 = (y+1)*width +x;
+			int lp2 = (y+2)*width +x;
+			int lm1 = (y-1)*width +x;
+			int lm2 = (y-2)*width +x;
+			
+			// Compute vertical and horizontal gradients in the green channel
+			float adv = fabsf(ogreen[lp1] - ogreen[lm1]);
+			float adh = fabsf(ogreen[l-1] - ogreen[l+1]);
+			float dh0, dv0;
+			
+			dh0 = 2.0 * orb[l] - orb[l+2] - orb[l-2];	
+			dv0 = 2.0 * orb[l] - orb[lp2] - orb[lm2];
+			
+			// Add vertical and horizontal differences
+			adh = adh + fabsf(dh0);
+			adv = adv + fabsf(dv0);
+			
+			// If vertical and horizontal differences are similar, compute an isotropic average
+			if (fabsf(adv - adh) < threshold)
+				
+				ogreen[l] = (ogreen[lm1] +  ogreen[lp1] +  ogreen[l-1] + ogreen[l+1]) /4.0 + (dh0 + dv0) / 8.0;
+			
+			// Else If horizontal differences are smaller, compute horizontal average
+			else if (adh < adv )
+				
+				ogreen[l] = (ogreen[l-1] + ogreen[l+1])/2.0 + (dh0)/4.0;
+			
+			// Else If vertical differences are smaller, compute vertical average			
+			else if ( adv < adh ) 			
+				
+				ogreen[l] = (ogreen[lp1] + ogreen[lm1])/2.0 + (dv0)/4.0;
+			
+		}
+	}
+	
+}
+
+
+
+
 /**
  * \brief  Classical Adams-Hamilton demosaicking algorithm
  *
@@ -91,106 +240,101 @@ void demosaicking_adams(float threshold, int redx,int redy,float *ired,float *ig
 	wxCopy(iblue,oblue,width*height);
 	
 	
-	// Initializations
-	int bluex = 1 - redx;
-	int bluey = 1 - redy;
-	
+	// Interpolate green with the instance of the CFA phase
+	switch (redx + 2 * redy) {
+		case 0: demosaicking_adams_green<0, 0>(threshold, ored, ogreen, oblue, width, height); break;
+		case 1: demosaicking_adams_green<1, 0>(threshold, ored, ogreen, oblue, width, height); break;
+		case 2: demosaicking_adams_green<0, 1>(threshold, ored, ogreen, oblue, width, height); break;
+		default: demosaicking_adams_green<1, 1>(threshold, ored, ogreen, oblue, width, height); break;
+	}
 	
-	// CFA Mask of color per pixel
-	unsigned char* mask = (unsigned char *) malloc(width*height*sizeof(unsigned char));
-	
-	for(int x=0;x<width;x++)
-		for(int y=0;y<height;y++){
-			
-			if (x%2 == redx && y%2 == redy) mask[y*width+x] = REDPOSITION;
-			else  if (x%2 == bluex && y%2 == bluey) mask[y*width+x] = BLUEPOSITION;
-			else 	mask[y*width+x] = GREENPOSITION;
-			
-		}
 	
+	// compute the bilinear on the differences of the red and blue with the already interpolated green
+	demosaicking_bilinear_red_blue(redx,redy,ored,ogreen,oblue,width,height);
 	
+}
+
+
+
+
+/**
+ * \brief  Bilinear interpolation of the differences of one channel sampled at (CX + 2i, CY + 2j) 
+ *
+ * Rows are walked with stride 2 so that the position of each pixel in the CFA is known without any test:
+ * green pixels in rows of the channel take the horizontal average, green pixels in its columns the vertical average 
+ * and pixels of the other non green channel the diagonal average.
+ *
+ * The mirror symmetry is only computed for the first and last rows and columns, the interior loops use constant 
+ * neighbour offsets.
+ *
+ */
+
+template<int CX, int CY>
+static void bilinear_difference(float *oc, int width, int height)
+{
 	
+	int gn, gs, ge, gw;
 	
-	// Interpolate the green channel by bilinear on the boundaries  
-	// make the average of four neighbouring green pixels: Nourth, South, East, West
-	for(int x=0;x<width;x++)
-		for(int y=0;y<height;y++)
-			if ( (mask[y*width+ x] != GREENPOSITION) && (x < 3 || y < 3 || x>= width - 3 || y>= height - 3 )) { 
-				
-				
-				int gn, gs, ge, gw;
-				
-				if (y > 0)  gn = y-1;	else    gn = 1;
-				if (y < height-1)	gs = y+1;  else  gs = height - 2 ;
-				if (x < width-1)  ge = x+1;  else  ge = width-2;
-				if (x > 0) gw = x-1;	else  gw = 1;
-				
-				ogreen[y*width + x] = (ogreen[gn*width + x] +  ogreen[gs*width + x] + ogreen[y*width + gw] +  ogreen[y*width + ge])/ 4.0;
-				
-			}
+	// first and last x of parity 1-CX with both horizontal neighbours inside the image
+	int xa = (CX == 1) ? 2 : 1;
+	int xb = width - 2;
 	
+	// x of parity 1-CX on the first and last columns, -1 if none
+	int xborder[2] = { (CX == 1) ? 0 : -1, (((width-1) & 1) == 1-CX && width > 1) ? width-1 : -1 };
 	
 	
-	// Interpolate the green by Adams algorithm inside the image    
-	// First interpolate green directionally
-	for(int x=3;x<width-3;x++)
-		for(int y=3;y<height-3;y++)
-			if (mask[y*width+ x] != GREENPOSITION ) {  
-				
-				
-				int l = y*width+x;
-				int lp1 = (y+1)*width +x;
-				int lp2 = (y+2)*width +x;
-				int lm1 = (y-1)*width +x;
-				int lm2 = (y-2)*width +x;
-				
-				// Compute vertical and horizontal gradients in the green channel
-				float adv = fabsf(ogreen[lp1] - ogreen[lm1]);
-				float adh = fabsf(ogreen[l-1] - ogreen[l+1]);
-				float dh0, dv0;
-				
-				// If current pixel is blue, we compute the horizontal and vertical blue second derivatives
-				// else is red, we compute the horizontal and vertical red second derivatives
-				if (mask[l] == BLUEPOSITION){  
-					
-					dh0 = 2.0 * oblue[l] - oblue[l+2] - oblue[l-2];	
-					dv0 = 2.0 * oblue[l] - oblue[lp2] - oblue[lm2];
-					
-				} else { 			
-					
-					
-					dh0 = 2.0 * ored[l] - ored[l+2] - ored[l-2];	
-					dv0 = 2.0 * ored[l] - ored[lp2] - ored[lm2];
-					
-				}	
-				
-				// Add vertical and horizontal differences
-				adh = adh + fabsf(dh0);
-				adv = adv + fabsf(dv0);
-				
-				// If vertical and horizontal differences are similar, compute an isotropic average
-				if (fabsf(adv - adh) < threshold)
-					
-					ogreen[l] = (ogreen[lm1] +  ogreen[lp1] +  ogreen[l-1] + ogreen[l+1]) /4.0 + (dh0 + dv0) / 8.0;
-				
-				// Else If horizontal differences are smaller, compute horizontal average
-				else if (adh < adv )
-					
-					ogreen[l] = (ogreen[l-1] + ogreen[l+1])/2.0 + (dh0)/4.0;
-				
-				// Else If vertical differences are smaller, compute vertical average			
-				else if ( adv < adh ) 			
-					
-					ogreen[l] = (ogreen[lp1] + ogreen[lm1])/2.0 + (dv0)/4.0;
-				
-			}
-	
+	// Rows of the channel: green pixels between two samples
+	for(int y=CY; y < height;y+=2) {
+		
+		float *row = oc + y*width;
+		
+		for(int x=xa; x <= xb;x+=2)
+			row[x] = ( row[x+1] + row[x-1])/2.0;
+		
+		// Compute west, east positions taking a mirror symmetry at the boundaries
+		for(int k=0; k < 2; k++) {
+			
+			int x = xborder[k];
+			if (x < 0) continue;
+			
+			mirror_neighbours(x, y, width, height, gn, gs, ge, gw);
+			
+			row[x] = ( row[ge] + row[gw])/2.0;
+			
+		}
+		
+	}
 	
-	// compute the bilinear on the differences of the red and blue with the already interpolated green
-	demosaicking_bilinear_red_blue(redx,redy,ored,ogreen,oblue,width,height);
 	
+	// Other rows: green pixels below and above a sample, and pixels of the other channel
+	for(int y=1-CY; y < height;y+=2) {
+		
+		// Compute north, south positions taking a mirror symmetry at the boundaries
+		mirror_neighbours(0, y, width, height, gn, gs, ge, gw);
+		
+		float *row = oc + y*width;
+		float *rn = oc + gn*width;
+		float *rs = oc + gs*width;
+		
+		for(int x=CX; x < width;x+=2)
+			row[x] = ( rn[x] + rs[x])/2.0;
+		
+		for(int x=xa; x <= xb;x+=2)
+			row[x] =  (rn[x+1] + rn[x-1]  +  rs[x+1] +  rs[x-1])/4.0;
+		
+		for(int k=0; k < 2; k++) {
+			
+			int x = xborder[k];
+			if (x < 0) continue;
+			
+			mirror_neighbours(x, y, width, height, gn, gs, ge, gw);
+			
+			row[x] =  (rn[ge] + rn[gw]  +  rs[ge] +  rs[gw])/4.0;
+			
+		}
+		
+	}
 	
-	free(mask);
 }
 
 
@@ -211,25 +355,6 @@ void demosaicking_bilinear_red_blue(int redx,int redy,float *ored,float *ogreen,
 {
 	
 	
-	
-	//Initializations 
-	int bluex = 1 - redx;
-	int bluey = 1 - redy;
-	
-	
-	// Mask of color per pixel
-	unsigned char* mask = (unsigned char *) malloc(width*height*sizeof(unsigned char));
-	
-	for(int x=0;x<width;x++)
-		for(int y=0;y<height;y++){
-			
-			if (x%2 == redx && y%2 == redy) mask[y*width+x] = REDPOSITION;
-			else  if (x%2 == bluex && y%2 == bluey) mask[y*width+x] = BLUEPOSITION;
-			else 	mask[y*width+x] = GREENPOSITION;
-			
-		}
-	
-	
 	// Compute the differences  
 	for(int i=0; i < width*height;i++){
 		
@@ -240,56 +365,13 @@ void demosaicking_bilinear_red_blue(int redx,int redy,float *ored,float *ogreen,
 	
 	
 	
-	// Interpolate the blue differences making the average of possible values depending on the CFA structure 
-	for(int x=0; x < width;x++)
-		for(int y=0; y < height;y++)
-			if (mask[y*width+x] != BLUEPOSITION){
-				
-				int gn, gs, ge, gw;
-				
-				// Compute north, south, west, east positions
-				// taking a mirror symmetry at the boundaries
-				if (y > 0)  gn = y-1;	else    gn = 1;
-				if (y < height-1)	gs = y+1;  else  gs = height - 2 ;
-				if (x < width-1)  ge = x+1;  else  ge = width-2;
-				if (x > 0) gw = x-1;	else  gw = 1;
-				
-				if (mask[y*width+x] == GREENPOSITION && y % 2 == bluey) 
-					oblue[y*width+x] = ( oblue[y*width+ge] + oblue[y*width+gw])/2.0;
-				else if (mask[y*width+x] == GREENPOSITION  && x % 2 == bluex) 
-					oblue[y*width+x] = ( oblue[gn*width+x] + oblue[gs*width+x])/2.0;
-				else {
-					oblue[y*width+x] =  (oblue[gn*width+ge] + oblue[gn*width + gw]  +  oblue[gs*width + ge] +  oblue[gs*width +gw])/4.0;		 
-				}
-				
-			}
-	
-	
-	
-	
-	// Interpolate the blue differences making the average of possible values depending on the CFA structure
-	for(int x=0;x<width;x++)
-		for(int y=0;y<height;y++)
-			if (mask[y*width+x] != REDPOSITION){
-				
-				int gn, gs, ge, gw;
-				
-				// Compute north, south, west, east positions
-				// taking a mirror symmetry at the boundaries
-				if (y > 0)  gn = y-1;	else    gn = 1;
-				if (y < height-1)	gs = y+1;  else  gs = height - 2 ;
-				if (x < width-1)  ge = x+1;  else  ge = width-2;
-				if (x > 0) gw = x-1;	else  gw = 1;
-				
-				if (mask[y*width+x] == GREENPOSITION && y % 2 == redy) 
-					ored[y*width+x] = ( ored[y*width+ge] + ored[y*width+gw])/2.0;
-				else if (mask[y*width+x] == GREENPOSITION  && x % 2 == redx) 
-					ored[y*width+x] = ( ored[gn*width+x] + ored[gs*width+x])/2.0;
-				else {
-					ored[y*width+x] =  (ored[gn*width+ge] + ored[gn*width + gw]  +  ored[gs*width + ge] +  ored[gs*width +gw])/4.0;	 
-				}
-				
-			}
+	// Interpolate the blue and red differences making the average of possible values depending on the CFA structure 
+	switch (redx + 2 * redy) {
+		case 0: bilinear_difference<1, 1>(oblue, width, height); bilinear_difference<0, 0>(ored, width, height); break;
+		case 1: bilinear_difference<0, 1>(oblue, width, height); bilinear_difference<1, 0>(ored, width, height); break;
+		case 2: bilinear_difference<1, 0>(oblue, width, height); bilinear_difference<0, 1>(ored, width, height); break;
+		default: bilinear_difference<0, 0>(oblue, width, height); bilinear_difference<1, 1>(ored, width, height); break;
+	}
 	
 	
 	// Make back the differences
@@ -300,9 +382,6 @@ void demosaicking_bilinear_red_blue(int redx,int redy,float *ored,float *ogreen,
 	}
 	
 	
-	
-	free(mask);
-	
 }
 
 
@@ -312,161 +391,418 @@ void demosaicking_bilinear_red_blue(int redx,int redy,float *ored,float *ogreen,
 
 
 /**
- * \brief  NLmeans based demosaicking
+ * \brief  Exp(-x) for x >= 0, zero for x >= LUTMAXM1 as sLUT
  *
- * For each value to be filled, a weigthed average of original CFA values of the same channel is performed.
- * The weight depends on the difference of a 3x3 color patch 
- *
- * @param[in]  ired, igreen, iblue  initial demosaicked image
- * @param[out] ored, ogreen, oblue  demosaicked output 
- * @param[in]  (redx, redy)  coordinates of the red pixel: (0,0), (0,1), (1,0), (1,1)
- * @param[in]  bloc  research block of size (2+bloc+1) x (2*bloc+1)
- * @param[in]  h kernel bandwidth 
- * @param[in]  width, height size of the image
+ * Written without branches nor table so that the loops calling it are vectorized.  -x*log2(e) = n + r with n integer 
+ * and |r| <= 1/2, Exp(r*ln2) is computed with its Taylor polynomial of degree 7 and 2^n is written in the exponent 
+ * bits.  The relative error is below 1e-7, that of the linear interpolation of the table of sLUT is 1.25e-7.
  *
  */
-
-
-void demosaicking_nlmeans(int bloc, float h,int redx,int redy,float *ired,float *igreen,float *iblue,float *ored,float *ogreen,float *oblue,int width,int height)
+static inline float nlmeans_exp(float x)
 {
 	
+	float t = - MIN(x, (float) LUTMAXM1) * 1.44269504f;
+	int n = (int) (t - 0.5f);
+	float u = (t - (float) n) * 0.693147181f;
 	
-	// Initializations
-	int bluex = 1 - redx;
-	int bluey = 1 - redy;
-
-	
-	
-	// CFA Mask of color per pixel
-	unsigned char *cfamask = new unsigned char[width*height];
-	
-	
-	for(int x=0;x<width;x++)
-		for(int y=0;y<height;y++){
-			
-			if (x%2 == redx && y%2 == redy) cfamask[y*width+x] = REDPOSITION;
-			else  if (x%2 == bluex && y%2 == bluey) cfamask[y*width+x] = BLUEPOSITION;
-			else 	cfamask[y*width+x] = GREENPOSITION;
-			
-		}
+	float y = 1.0f + u*(1.0f + u*(0.5f + u*(1.66666667e-1f + u*(4.16666667e-2f + u*(8.33333333e-3f + u*(1.38888889e-3f + u*1.98412698e-4f))))));
 	
+	int e = (n + 127) << 23;
+	float p;
+	memcpy(&p, &e, sizeof(float));
 	
-	wxCopy(ired,ored,width*height);
-	wxCopy(igreen,ogreen,width*height);
-	wxCopy(iblue,oblue,width*height);
-	
-	
-	
-	// Tabulate the function Exp(-x) for x>0.
-	int luttaille = (int) (LUTMAX*LUTPRECISION);
-	float *lut = new float[luttaille];
-	
-	sFillLut(lut, luttaille);
+	return (x >= (float) LUTMAXM1) ? 0.0f : y*p;
+}
+
+
+
+/**
+ * \brief  NLmeans weighted sums for the pixels [xa, xb) x [ya, yb) and the CFA phase with red pixel at (RedX, RedY)
+ *
+ * The weights are computed offset-major: for each displacement (dx, dy) of the research block, the squared color 
+ * differences between the image and its translation are computed once and summed over 3x3 patches with running 
+ * sums, as in precompute_BM of BM3D, so that each patch distance costs a few additions instead of 27 multiply-adds.  
+ * The weighted sums of every pixel are accumulated in per-pixel buffers.
+ *
+ * Each row is walked twice with stride 2, once per column parity, so that the channels of the current pixel and 
+ * of its candidate are known without any test, and pairs of the same channel are skipped.
+ *
+ * diff and hsum are buffers of (yb - ya + 2) rows that hold the rows ya-1 to yb.  Only the pixels of the tile 
+ * [xa, xb) x [ya, yb) of sum and sumweight are written, so tiles are processed in parallel.  The sums of each pixel 
+ * are accumulated in the same order whatever the tiles, so the result does not depend on the number of threads.
+ *
+ */
+
+template<int RedX, int RedY>
+static void nlmeans_tile(int xa, int xb, int ya, int yb, int bloc, float h, float **ichannel, float **sum, float **sumweight, float *diff, float *hsum, int width, int height)
+{
 	
+	float *ired = ichannel[REDPOSITION];
+	float *igreen = ichannel[GREENPOSITION];
+	float *iblue = ichannel[BLUEPOSITION];
 	
+	// Scale of the distances, the patch has 27 values
+	float scale = 1.0 / (27.0 * h);
 	
 	
-	// for each pixel
-	for(int y=2; y <height-2; y++)
-		for(int x=2; x<width-2; x++)
+	// for each displacement of the research block
+	for(int dy=-bloc; dy <= bloc; dy++)
+		for(int dx=-bloc; dx <= bloc; dx++)
 		{
-			// index of current pixel
-			int l=y*width+x;
-			
 			
-			// Learning zone depending on the window size
-			int imin=MAX(x-bloc,1);
-			int jmin=MAX(y-bloc,1);
+			// Pixels (x, y) of [xa, xb-1] x [ya, yb-1] whose candidate (x+dx, y+dy) lies in [1, width-2] x [1, height-2]
+			int x0 = MAX(xa, 1-dx), x1 = MIN(xb-1, width-2-dx);
+			int y0 = MAX(ya, 1-dy), y1 = MIN(yb-1, height-2-dy);
 			
-			int imax=MIN(x+bloc,width-2);
-			int jmax=MIN(y+bloc,height-2);
+			if (x0 > x1 || y0 > y1) continue;
 			
+			int d = dy*width + dx;
 			
-			// auxiliary variables for computing average
-			float red=0.0;
-			float green=0.0;
-			float blue=0.0;
 			
-			float rweight=0.0;
-			float gweight=0.0;
-			float bweight=0.0;
+			// Squared color differences and horizontal sums, on the rows and columns covered by the patches
+			for(int y=y0-1; y <= y1+1; y++) {
+				
+				float *dr = diff + (y-ya+1)*width;
+				float *hr = hsum + (y-ya+1)*width;
+				float *r = ired + y*width, *g = igreen + y*width, *b = iblue + y*width;
+				
+				for(int x=x0-1; x <= x1+1; x++) {
+					
+					float dred = r[x] - r[x+d];
+					float dgreen = g[x] - g[x+d];
+					float dblue = b[x] - b[x+d];
+					
+					dr[x] = dred*dred + dgreen*dgreen + dblue*dblue;
+					
+				}
+				
+				for(int x=x0; x <= x1; x++)
+					hr[x] = dr[x-1] + dr[x] + dr[x+1];
+				
+			}
 			
 			
-			// for each pixel in the neighborhood
-			for(int j=jmin;j<=jmax;j++)
-				for(int i=imin;i<=imax;i++) {
+			// Accumulate the weighted candidates
+			for(int y=y0; y <= y1; y++) {
+				
+				// column parity and channel of the red or blue pixels of the current and of the candidate row
+				int yrb = cfa_rb_column<RedX, RedY>(y);
+				int ycolor = ((y & 1) == RedY) ? REDPOSITION : BLUEPOSITION;
+				int jrb = cfa_rb_column<RedX, RedY>(y+dy);
+				int jcolor = (((y+dy) & 1) == RedY) ? REDPOSITION : BLUEPOSITION;
+				
+				float *hr = hsum + (y-ya+1)*width;
+				
+				for(int p=0; p < 2; p++) {
 					
-					// index of neighborhood pixel
-					int l0=j*width+i;
+					int color = (p == yrb) ? ycolor : GREENPOSITION;
+					int ccolor = (((p+dx) & 1) == jrb) ? jcolor : GREENPOSITION;
 					
 					// We only interpolate channels differents of the current pixel channel
-					if (cfamask[l]!=cfamask[l0]) {
-						
+					if (color == ccolor) continue;
+					
+					float *ic = ichannel[ccolor] + y*width + d;
+					float *s = sum[ccolor] + y*width;
+					float *sw = sumweight[ccolor] + y*width;
+					
+					for(int x=x0 + ((p - x0) & 1); x <= x1; x+=2) {
 						
 						// Distances computed on color
-						float some = 0.0;
-						
-						some = l2_distance_r1(ired,  x, y, i,
-											  j, width);
-						some += l2_distance_r1(igreen,  x, y, i,
-											   j, width);
-						some += l2_distance_r1(iblue,  x, y, i,
-											   j, width);
-						
-						
+						float some = hr[x-width] + hr[x] + hr[x+width];
 						
 						// Compute weight
-						some= some / (27.0 * h);
+						float weight = nlmeans_exp(some * scale);
 						
-						float weight = sLUT(some,lut);
-						
-						// Add pixel to corresponding channel average
-						
-						if (cfamask[l0] == GREENPOSITION)  {
-							
-							green += weight*igreen[l0];
-							gweight+= weight;
-							
-						} else if (cfamask[l0] == REDPOSITION) {
-							
-							red += weight*ired[l0];
-							rweight+= weight;
-							
-						} else {
-							
-							blue += weight*iblue[l0];
-							bweight+= weight;
-						}
+						s[x] += weight*ic[x];
+						sw[x] += weight;
 						
 					}
 					
 				}
+				
+			}
+			
+		}
+	
+}
+
+
+
+/**
+ * \brief  Test whether the variance of each channel on the pixels [xa, xb) x [ya, yb) is below flat
+ */
+static int nlmeans_flat_tile(int xa, int xb, int ya, int yb, float flat, float **ichannel, int width)
+{
+	
+	int n = (xb - xa) * (yb - ya);
+	
+	for(int c=0; c < 3; c++) {
+		
+		double mean = 0.0, var = 0.0;
+		
+		for(int y=ya; y < yb; y++)
+			for(int x=xa; x < xb; x++) {
+				
+				float value = ichannel[c][y*width+x];
+				mean += value;
+				var += value*value;
+				
+			}
+		
+		mean /= n;
+		var = var / n - mean * mean;
+		
+		if (var >= flat) return 0;
+		
+	}
+	
+	return 1;
+}
+
+
+
+/**
+ * \brief  NLmeans based demosaicking for the CFA phase with red pixel at (RedX, RedY)
+ *
+ * The image is divided in tiles of NLMEANS_BAND rows processed in parallel by nlmeans_tile when compiled with OpenMP.  
+ * Each thread allocates its difference buffers once and keeps them for all its tiles.  If flat > 0, the tiles are 
+ * also NLMEANS_TILE_WIDTH columns wide, and those where the variance of each channel of the input is below flat are 
+ * skipped and keep their input values.  Otherwise the tiles are whole bands of rows, so the vectorized loops cover 
+ * the same pixels whatever the number of threads.
+ *
+ */
+
+template<int RedX, int RedY>
+static void demosaicking_nlmeans_phase(int bloc, float h, float flat, float *ired,float *igreen,float *iblue,float *ored,float *ogreen,float *oblue,float *scratch,int width,int height)
+{
+	
+	int size = width*height;
+	int nbands = (height - 4 + NLMEANS_BAND - 1) / NLMEANS_BAND;
+	int tilewidth = (flat > 0.0f) ? NLMEANS_TILE_WIDTH : width;
+	int ncolumns = (width - 4 + tilewidth - 1) / tilewidth;
+	
+	if (nbands <= 0 || ncolumns <= 0) return;
+	
+	// Weighted sums and sums of weights of each channel, indexed by channel position
+	float *sum[3], *sumweight[3];
+	
+	for(int c=0; c < 3; c++) {
+		
+		sum[c] = scratch + 2*c*size;
+		sumweight[c] = scratch + (2*c+1)*size;
+		
+		for(int i=0; i < size; i++) sum[c][i] = sumweight[c][i] = 0.0;
+		
+	}
+	
+	float *ichannel[3];
+	ichannel[GREENPOSITION] = igreen;
+	ichannel[REDPOSITION] = ired;
+	ichannel[BLUEPOSITION] = iblue;
+	
+	
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+	{
+		
+		// Squared color differences for the current displacement and their sums over 3 consecutive pixels of a row
+		float *diff = new float[(NLMEANS_BAND + 2)*width];
+		float *hsum = new float[(NLMEANS_BAND + 2)*width];
+		
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+		for(int tile=0; tile < nbands*ncolumns; tile++) {
+			
+			int ya = 2 + (tile / ncolumns)*NLMEANS_BAND, yb = MIN(ya + NLMEANS_BAND, height-2);
+			int xa = 2 + (tile % ncolumns)*tilewidth, xb = MIN(xa + tilewidth, width-2);
+			
+			if (flat > 0.0f && nlmeans_flat_tile(xa, xb, ya, yb, flat, ichannel, width)) continue;
+			
+			nlmeans_tile<RedX, RedY>(xa, xb, ya, yb, bloc, h, ichannel, sum, sumweight, diff, hsum, width, height);
+			
+		}
+		
+		delete[] diff;
+		delete[] hsum;
+		
+	}
+	
+	
+	// Set value to each pixel, the pixels of skipped tiles have no weight and keep their input values
+	for(int y=2; y <height-2; y++)
+		for(int x=2; x<width-2; x++)
+		{
 			
+			int l=y*width+x;
+			int color = cfa_position<RedX, RedY>(x, y);
 			
-			// Set value to current pixel
-			if (cfamask[l] != GREENPOSITION && gweight > fTiny)  ogreen[l]  =   green / gweight; 
+			if (color != GREENPOSITION && sumweight[GREENPOSITION][l] > fTiny)  ogreen[l] = sum[GREENPOSITION][l] / sumweight[GREENPOSITION][l]; 
 			else  ogreen[l] = igreen[l];
 			
-			if ( cfamask[l] != REDPOSITION && rweight > fTiny)  ored[l]  =  red / rweight ;
+			if (color != REDPOSITION && sumweight[REDPOSITION][l] > fTiny)  ored[l] = sum[REDPOSITION][l] / sumweight[REDPOSITION][l];
 			else    ored[l] = ired[l];
 			
-			if  (cfamask[l] != BLUEPOSITION && bweight > fTiny)   oblue[l] =  blue / bweight;
+			if (color != BLUEPOSITION && sumweight[BLUEPOSITION][l] > fTiny)  oblue[l] = sum[BLUEPOSITION][l] / sumweight[BLUEPOSITION][l];
 			else  oblue[l] = iblue[l];
 			
-			
-		} 
+		}
 	
-	delete[] cfamask;
-	delete[] lut;
+}
+
+
+
+
+/**
+ * \brief  NLmeans based demosaicking
+ *
+ * For each value to be filled, a weigthed average of original CFA values of the same channel is performed.
+ * The weight depends on the difference of a 3x3 color patch 
+ *
+ * @param[in]  ired, igreen, iblue  initial demosaicked image
+ * @param[out] ored, ogreen, oblue  demosaicked output 
+ * @param[in]  (redx, redy)  coordinates of the red pixel: (0,0), (0,1), (1,0), (1,1)
+ * @param[in]  bloc  research block of size (2+bloc+1) x (2*bloc+1)
+ * @param[in]  h kernel bandwidth 
+ * @param[in]  width, height size of the image
+ * @param[in]  flat  tiles where the variance of each channel is below flat keep their input values, 0 to disable
+ * @param[in]  scratch  buffer of demosaicking_nlmeans_scratch_size(width, height) floats, or NULL
+ *
+ */
+
+
+void demosaicking_nlmeans(int bloc, float h,int redx,int redy,float *ired,float *igreen,float *iblue,float *ored,float *ogreen,float *oblue,int width,int height, float flat, float *scratch)
+{
+	
+	
+	wxCopy(ired,ored,width*height);
+	wxCopy(igreen,ogreen,width*height);
+	wxCopy(iblue,oblue,width*height);
+	
+	float *buffer = scratch ? scratch : new float[demosaicking_nlmeans_scratch_size(width, height)];
+	
+	
+	switch (redx + 2 * redy) {
+		case 0: demosaicking_nlmeans_phase<0, 0>(bloc, h, flat, ired, igreen, iblue, ored, ogreen, oblue, buffer, width, height); break;
+		case 1: demosaicking_nlmeans_phase<1, 0>(bloc, h, flat, ired, igreen, iblue, ored, ogreen, oblue, buffer, width, height); break;
+		case 2: demosaicking_nlmeans_phase<0, 1>(bloc, h, flat, ired, igreen, iblue, ored, ogreen, oblue, buffer, width, height); break;
+		default: demosaicking_nlmeans_phase<1, 1>(bloc, h, flat, ired, igreen, iblue, ored, ogreen, oblue, buffer, width, height); break;
+	}
+	
+	
+	if (!scratch) delete[] buffer;
+	
+}
+
+
+
+/**
+ * \brief  Number of floats of the scratch buffer of demosaicking_nlmeans
+ *
+ * @param[in]  width, height size of the image
+ *
+ */
+
+int demosaicking_nlmeans_scratch_size(int width, int height)
+{
+	// Weighted sums and sums of weights of the three channels
+	return 6 * width * height;
+}
+
+
+
+
+/**
+ * \brief  Number of floats of the scratch buffer of chromatic_median
+ *
+ * @param[in]  side  median in a (2*side+1) x (2*side+1) window
+ * @param[in]  width width of the image
+ *
+ */
+
+int chromatic_median_scratch_size(float side, int width)
+{
+	// Rows of the window of wxMedianRows above and below the center
+	int halo = (int) (side + 1.0);
 	
+	return 2 * (2 * CHROMATIC_BAND + 2 * halo) * width;
 }
 
 
 
+/**
+ * \brief  One iteration of chromatic_median on the rows [ya, yb)
+ *
+ * U and V are computed on the rows of the band and of its halo, filtered by wxMedianRows while they are in cache, 
+ * and converted back to RGB with the Y of the input directly into the output, where the CFA values are put back.
+ *
+ */
+
+static void chromatic_median_band(int ya, int yb, int redx, int redy, int projflag, float side, float *ired, float *igreen, float *iblue, float *ored, float *ogreen, float *oblue, float *scratch, int width, int height)
+{
+	
+	int halo = (int) (side + 1.0);
+	int ra = MAX(0, ya - halo), rb = MIN(height, yb + halo);
+	
+	float *u = scratch;
+	float *v = u + (CHROMATIC_BAND + 2 * halo) * width;
+	float *u0 = v + (CHROMATIC_BAND + 2 * halo) * width;
+	float *v0 = u0 + CHROMATIC_BAND * width;
+	
+	
+	// Chromatic components of the band and its halo, as wxRgb2Yuv
+	for(int l=ra*width, i=0; l < rb*width; l++, i++) {
+		
+		float y = ( COEFF_YR *  ired[l] + COEFF_YG * igreen[l] + COEFF_YB * iblue[l]);
+		u[i] = ired[l] - y;
+		v[i] = iblue[l] - y;
+		
+	}
+	
+	
+	// Perform a Median on UV components
+	wxMedianRows(u, ra, u0, side, ya, yb, width, height);
+	wxMedianRows(v, ra, v0, side, ya, yb, width, height);
+	
+	
+	// Transform back to RGB, as wxYuv2Rgb
+	for(int l=ya*width, i=0; l < yb*width; l++, i++) {
+		
+		float y = ( COEFF_YR *  ired[l] + COEFF_YG * igreen[l] + COEFF_YB * iblue[l]);
+		
+		ogreen[l] = ( y - COEFF_YR * (u0[i] + y) - COEFF_YB * (v0[i] + y) ) / COEFF_YG;
+		ored[l] = u0[i] + y;
+		oblue[l] = v0[i] + y;
+		
+	}
+	
+	
+	// If projection flag activated put back original CFA values
+	if (projflag)
+		for(int y=ya; y < yb; y++) {
+			
+			int l = y*width;
+			int xrb = ((y & 1) == redy) ? redx : 1 - redx;
+			float *irb = ((y & 1) == redy) ? ired : iblue;
+			float *orb = ((y & 1) == redy) ? ored : oblue;
+			
+			for(int x=xrb; x < width; x+=2) orb[l+x] = irb[l+x];
+			for(int x=1-xrb; x < width; x+=2) ogreen[l+x] = igreen[l+x];
+			
+		}
+	
+}
+
+
 
 /**
  * \brief  Iterate median filter on chromatic components of the image
  *
+ * Each iteration is a single pass on bands of CHROMATIC_BAND rows.  The scratch buffer of 
+ * chromatic_median_scratch_size(side, width) floats may be given by the caller to be reused across calls, 
+ * otherwise it is allocated.  When iter > 1 the input is overwritten by the intermediate iterations.
+ *
  *
  * @param[in]  ired, igreen, iblue  initial  image
  * @param[in]  iter  number of iteracions
@@ -475,81 +811,138 @@ void demosaicking_nlmeans(int bloc, float h,int redx,int redy,float *ired,float
  * @param[in]  side  median in a (2*side+1) x (2*side+1) window
  * @param[in]  projflag if not zero, values of the original CFA are kept 
  * @param[in]  width, height size of the image
+ * @param[in]  scratch  buffer of chromatic_median_scratch_size(side, width) floats, or NULL
  *
  */
 
 
-void chromatic_median(int iter,int redx,int redy,int projflag,float side,float *ired,float *igreen, float *iblue,float *ored,float *ogreen,float *oblue,int width,int height)
+void chromatic_median(int iter,int redx,int redy,int projflag,float side,float *ired,float *igreen, float *iblue,float *ored,float *ogreen,float *oblue,int width,int height, float *scratch)
 {
 	
 	
 	int size=height*width;
 	
-	// Auxiliary variables for computing chromatic components
-	float *y=new float[size];
-	float *u=new float[size];
-	float *v=new float[size];
-	float *u0=new float[size];
-	float *v0=new float[size];
-	
-	int bluex=1-redx;
-	int bluey=1-redy;
+	float *buffer = scratch ? scratch : new float[chromatic_median_scratch_size(side, width)];
 	
 	
 	// For each iteration
 	for(int i=1;i<=iter;i++){
 		
-		
-		// Transform to YUV
-		wxRgb2Yuv(ired,igreen,iblue,y,u,v,width,height); 
-		
-		// Perform a Median on YUV component
-		wxMedian(u,u0,side,1 ,width,height); 
-		wxMedian(v,v0,side,1 ,width,height); 
-		
-		
-		// Transform back to RGB
-		wxYuv2Rgb(ored,ogreen,oblue,y,u0,v0,width,height); 
-		
-		// If projection flag activated put back original CFA values
-		if (projflag)
-		{
-		
-			for(int x=0;x<width;x++)
-				for(int y=0;y<height;y++){
-					
-					int l=y*width+x;
-					
-					if (x%2==redx && y%2==redy) ored[l]=ired[l];
-					
-					else if (x%2==bluex && y%2==bluey) oblue[l]=iblue[l];
-					
-					else ogreen[l]=igreen[l];
-					
-				}
+		// The previous iteration is the input of this one
+		if (i > 1) {
+			
+			wxCopy(ored,ired,size);
+			wxCopy(ogreen,igreen,size);
+			wxCopy(oblue,iblue,size);
 			
 		}
 		
 		
-		wxCopy(ored,ired,size);
-		wxCopy(ogreen,igreen,size);
-		wxCopy(oblue,iblue,size);
+		for(int ya=0; ya < height; ya+=CHROMATIC_BAND)
+			chromatic_median_band(ya, MIN(ya + CHROMATIC_BAND, height), redx, redy, projflag, side, 
+								  ired, igreen, iblue, ored, ogreen, oblue, buffer, width, height);
 		
 	}
+	
+	
+	if (!scratch) delete[] buffer;
+	
+}
 
+
+
+
+
+
+
+/**
+ * \brief  Create a SSD demosaicking pipeline for images of size width x height
+ *
+ * The stages are copied.  The scratch buffers of demosaicking_nlmeans and chromatic_median are allocated once for 
+ * all the stages and all the calls to ssd_pipeline_run.  The other parameters take the values of 
+ * ssd_demosaicking_chain and may be changed before running the pipeline.
+ *
+ * @param[in]  nstages, stages  NLmeans stages, in the order they are applied
+ * @param[in]  side  median of the chromatic regularization in a (2*side+1) x (2*side+1) window
+ * @param[in]  width, height size of the images
+ *
+ */
+
+ssd_pipeline *ssd_pipeline_create(int nstages, const ssd_stage *stages, float side, int width, int height)
+{
+	
+	ssd_pipeline *pipeline = new ssd_pipeline;
+	
+	pipeline->width = width;
+	pipeline->height = height;
 	
-	// delete auxiliary memory
-	delete[] y;
-	delete[] u;
-	delete[] u0;
-	delete[] v;
-	delete[] v0;
+	pipeline->nstages = nstages;
+	pipeline->stages = new ssd_stage[nstages];
+	for(int k=0; k < nstages; k++) pipeline->stages[k] = stages[k];
 	
+	pipeline->threshold = 2.0;
+	pipeline->side = side;
+	pipeline->iter = 1;
+	pipeline->projflag = 1;
+	pipeline->flat = 0.0;
+	
+	pipeline->nlmeans_scratch = new float[demosaicking_nlmeans_scratch_size(width, height)];
+	pipeline->median_scratch = new float[chromatic_median_scratch_size(side, width)];
+	
+	return pipeline;
 }
 
 
 
+/**
+ * \brief  Free a pipeline created by ssd_pipeline_create
+ */
 
+void ssd_pipeline_destroy(ssd_pipeline *pipeline)
+{
+	
+	if (!pipeline) return;
+	
+	delete[] pipeline->stages;
+	delete[] pipeline->nlmeans_scratch;
+	delete[] pipeline->median_scratch;
+	delete pipeline;
+	
+}
+
+
+
+/**
+ * \brief  Run the demosaicking pipeline
+ *
+ * Adams-Hamilton initialization, then for each stage NLmeans demosaicking with the h and research block of the stage 
+ * followed by the chromatic regularization.  The input planes are used as intermediate buffers and are overwritten.
+ *
+ * @param[in]  pipeline  pipeline created by ssd_pipeline_create for the size of the image
+ * @param[in]  ired, igreen, iblue  initial  image
+ * @param[out] ored, ogreen, oblue  filtered output 
+ * @param[in]  (redx, redy)  coordinates of the red pixel: (0,0), (0,1), (1,0), (1,1)
+ *
+ */
+
+void ssd_pipeline_run(ssd_pipeline *pipeline, int redx,int redy,float *ired,float *igreen,float *iblue,float *ored,float *ogreen,float *oblue)
+{
+	
+	int width = pipeline->width;
+	int height = pipeline->height;
+	
+	
+	demosaicking_adams(pipeline->threshold,redx,redy,ired, igreen, iblue, ored, ogreen, oblue, width,height);
+	
+	
+	for(int k=0; k < pipeline->nstages; k++) {
+		
+		demosaicking_nlmeans(pipeline->stages[k].bloc,pipeline->stages[k].h,redx,redy,ored,ogreen,oblue,ired,igreen,iblue,width,height,pipeline->flat,pipeline->nlmeans_scratch);
+		chromatic_median(pipeline->iter,redx,redy,pipeline->projflag,pipeline->side,ired,igreen,iblue,ored,ogreen,oblue,width,height,pipeline->median_scratch);
+		
+	}
+	
+}
 
 
 
@@ -573,6 +966,8 @@ void chromatic_median(int iter,int redx,int redy,int projflag,float side,float *
  *
  * Output <- u;
  *
+ * This is ssd_pipeline_run with these stages, a research block of 15x15 and side = 1.5.
+ *
  *
  * @param[in]  ired, igreen, iblue  initial  image
  * @param[out] ored, ogreen, oblue  filtered output 
@@ -586,40 +981,16 @@ void chromatic_median(int iter,int redx,int redy,int projflag,float side,float *
 void ssd_demosaicking_chain(int redx,int redy,float *ired,float *igreen,float *iblue,float *ored,float *ogreen,float *oblue,int width,int height)
 {
 	
-	
-	////////////////////////////////////////////// Process
-	
-	
-
-	float h;
-	int dbloc = 7;
+	// h in {16,4,1} with a research block of 15x15
+	ssd_stage stages[3] = {{16.0, 7}, {4.0, 7}, {1.0, 7}};
 	float side = 1.5;
-	int iter = 1;
-	int projflag = 1;  
-	float threshold = 2.0;
-	
-	
-	demosaicking_adams(threshold,redx,redy,ired, igreen, iblue, ored, ogreen, oblue, width,height);
-	
-	
-
- 	h = 16.0;
-	demosaicking_nlmeans(dbloc,h,redx,redy,ored,ogreen,oblue,ired,igreen,iblue,width,height);
-	chromatic_median(iter,redx,redy,projflag,side,ired,igreen,iblue,ored,ogreen,oblue,width,height);
-	
-	
 	
- 	h = 4.0;
- 	demosaicking_nlmeans(dbloc,h,redx,redy,ored,ogreen,oblue,ired,igreen,iblue,width,height);
- 	chromatic_median(iter,redx,redy,projflag,side,ired,igreen,iblue,ored,ogreen,oblue,width,height);
- 	
- 	
 	
- 	h = 1.0;
- 	demosaicking_nlmeans(dbloc,h,redx,redy,ored,ogreen,oblue,ired,igreen,iblue,width,height);
- 	chromatic_median(iter,redx,redy,projflag,side,ired,igreen,iblue,ored,ogreen,oblue,width,height);
+	ssd_pipeline *pipeline = ssd_pipeline_create(3, stages, side, width, height);
 	
+	ssd_pipeline_run(pipeline, redx, redy, ired, igreen, iblue, ored, ogreen, oblue);
 	
+	ssd_pipeline_destroy(pipeline);
 	
 }
 
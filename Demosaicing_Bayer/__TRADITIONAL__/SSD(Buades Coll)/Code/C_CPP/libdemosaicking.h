@@ -113,17 +113,32 @@ void demosaicking_bilinear_red_blue(int redx,int redy,float *ored,float *ogreen,
  * @param[in]  bloc  research block of size (2+bloc+1) x (2*bloc+1)
  * @param[in]  h kernel bandwidth 
  * @param[in]  width, height size of the image
+ * @param[in]  flat  tiles where the variance of each channel is below flat keep their input values, 0 to disable
+ * @param[in]  scratch  buffer of demosaicking_nlmeans_scratch_size(width, height) floats, or NULL
  *
  */
 
 
-void demosaicking_nlmeans(int bloc, float h,int redx,int redy,float *ired,float *igreen,float *iblue,float *ored,float *ogreen,float *oblue,int width,int height);
+void demosaicking_nlmeans(int bloc, float h,int redx,int redy,float *ired,float *igreen,float *iblue,float *ored,float *ogreen,float *oblue,int width,int height, float flat = 0.0, float *scratch = NULL);
+
+
+
+/**
+ * \brief  Number of floats of the scratch buffer of demosaicking_nlmeans
+ *
+ * @param[in]  width, height size of the image
+ *
+ */
+
+int demosaicking_nlmeans_scratch_size(int width, int height);
 
 
 
 /**
  * \brief  Iterate median filter on chromatic components of the image
  *
+ * The scratch buffer of chromatic_median_scratch_size(side, width) floats may be given by the caller to be reused 
+ * across calls, otherwise it is allocated.  When iter > 1 the input is overwritten by the intermediate iterations.
  *
  * @param[in]  ired, igreen, iblue  initial  image
  * @param[in]  iter  number of iteracions
@@ -132,12 +147,106 @@ void demosaicking_nlmeans(int bloc, float h,int redx,int redy,float *ired,float
  * @param[in]  side  median in a (2*side+1) x (2*side+1) window
  * @param[in]  projflag if not zero, values of the original CFA are kept 
  * @param[in]  width, height size of the image
+ * @param[in]  scratch  buffer of chromatic_median_scratch_size(side, width) floats, or NULL
+ *
+ */
+
+
+
+void chromatic_median(int iter,int redx,int redy,int projflag,float side,float *ired,float *igreen, float *iblue,float *ored,float *ogreen,float *oblue,int width,int height, float *scratch = NULL);
+
+
+
+/**
+ * \brief  Number of floats of the scratch buffer of chromatic_median
+ *
+ * @param[in]  side  median in a (2*side+1) x (2*side+1) window
+ * @param[in]  width width of the image
+ *
+ */
+
+int chromatic_median_scratch_size(float side, int width);
+
+
+
+
+/**
+ * \brief  NLmeans stage of the SSD demosaicking pipeline
+ */
+
+typedef struct {
+	
+	float h;				// NLmeans kernel bandwidth
+	int bloc;				// NLmeans research block of size (2*bloc+1) x (2*bloc+1)
+	
+} ssd_stage;
+
+
+
+/**
+ * \brief  SSD demosaicking pipeline
  *
+ * Created by ssd_pipeline_create with its stages and its scratch buffers, which are reused by all the stages and by 
+ * all the images processed by ssd_pipeline_run.  threshold, iter, projflag and flat may be changed between runs.
+ */
+
+typedef struct {
+	
+	int width, height;		// size of the images
+	
+	int nstages;			// NLmeans stages, in the order they are applied
+	ssd_stage *stages;
+	
+	float threshold;		// threshold of the Adams-Hamilton initialization
+	float side;				// median of the chromatic regularization in a (2*side+1) x (2*side+1) window
+	int iter;				// iterations of the chromatic regularization
+	int projflag;			// if not zero, values of the original CFA are kept by the chromatic regularization
+	float flat;				// NLmeans keeps the tiles where the variance of each channel is below flat, 0 to disable
+	
+	float *nlmeans_scratch;	// scratch of demosaicking_nlmeans
+	float *median_scratch;	// scratch of chromatic_median
+	
+} ssd_pipeline;
+
+
+
+/**
+ * \brief  Create a SSD demosaicking pipeline for images of size width x height
+ *
+ * The stages are copied.  The other parameters take the values of ssd_demosaicking_chain.
+ *
+ * @param[in]  nstages, stages  NLmeans stages, in the order they are applied
+ * @param[in]  side  median of the chromatic regularization in a (2*side+1) x (2*side+1) window
+ * @param[in]  width, height size of the images
+ *
+ */
+
+ssd_pipeline *ssd_pipeline_create(int nstages, const ssd_stage *stages, float side, int width, int height);
+
+
+
+/**
+ * \brief  Free a pipeline created by ssd_pipeline_create
  */
 
+void ssd_pipeline_destroy(ssd_pipeline *pipeline);
 
 
-void chromatic_median(int iter,int redx,int redy,int projflag,float side,float *ired,float *igreen, float *iblue,float *ored,float *ogreen,float *oblue,int width,int height);
+
+/**
+ * \brief  Run the demosaicking pipeline
+ *
+ * Adams-Hamilton initialization, then for each stage NLmeans demosaicking with the h and research block of the stage 
+ * followed by the chromatic regularization.  The input planes are used as intermediate buffers and are overwritten.
+ *
+ * @param[in]  pipeline  pipeline created by ssd_pipeline_create for the size of the image
+ * @param[in]  ired, igreen, iblue  initial  image
+ * @param[out] ored, ogreen, oblue  filtered output 
+ * @param[in]  (redx, redy)  coordinates of the red pixel: (0,0), (0,1), (1,0), (1,1)
+ *
+ */
+
+void ssd_pipeline_run(ssd_pipeline *pipeline, int redx,int redy,float *ired,float *igreen,float *iblue,float *ored,float *ogreen,float *oblue);
 
 
 
@@ -162,6 +271,8 @@ void chromatic_median(int iter,int redx,int redy,int projflag,float side,float *
  *
  * Output <- u;
  *
+ * This is ssd_pipeline_run with these stages, a research block of 15x15 and side = 1.5.
+ *
  *
  * @param[in]  ired, igreen, iblue  initial  image
  * @param[out] ored, ogreen, oblue  filtered output 